@@ -0,0 +1,125 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// The five tabs filled from nothing, the way the initial lists come in: one
+// widget per callback with the event loop turning in between, until the first
+// paint. Once as it used to, relaying out and painting along the way, and
+// once inside MainWindow's bulk load. Device widgets need a MainWindow, so
+// every tab gets playback widgets, it is the layout and painting that counts.
+// Run with QT_QPA_PLATFORM=offscreen where there is no display.
+
+#include "playbackwidget.h"
+
+#include <QScrollArea>
+#include <QTabWidget>
+#include <QVBoxLayout>
+#include <QtTest>
+
+static const int TAB_COUNT = 5;
+
+class BenchBulkLoad : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void fill_data();
+    void fill();
+
+private:
+    pa_channel_map m_map;
+    pa_cvolume m_volume;
+};
+
+void BenchBulkLoad::initTestCase()
+{
+    pa_channel_map_init_stereo(&m_map);
+    pa_cvolume_set(&m_volume, m_map.channels, PA_VOLUME_NORM);
+}
+
+void BenchBulkLoad::fill_data()
+{
+    QTest::addColumn<int>("widgets");
+    QTest::addColumn<bool>("bulk");
+
+    QTest::newRow("200 incremental") << 200 << false;
+    QTest::newRow("200 bulk") << 200 << true;
+    QTest::newRow("1000 incremental") << 1000 << false;
+    QTest::newRow("1000 bulk") << 1000 << true;
+}
+
+void BenchBulkLoad::fill()
+{
+    QFETCH(int, widgets);
+    QFETCH(bool, bulk);
+
+    QBENCHMARK {
+        // The same nesting as MainWindow's tabs
+        QTabWidget notebook;
+        QWidget *contentLists[TAB_COUNT];
+        for (int tab = 0; tab < TAB_COUNT; tab++) {
+            contentLists[tab] = new QWidget;
+            contentLists[tab]->setLayout(new QVBoxLayout);
+            contentLists[tab]->setSizePolicy(QSizePolicy::Preferred, QSizePolicy::Maximum);
+
+            QScrollArea *scrollArea = new QScrollArea;
+            scrollArea->setWidgetResizable(true);
+            scrollArea->setWidget(contentLists[tab]);
+            notebook.addTab(scrollArea, QStringLiteral("Tab %1").arg(tab));
+        }
+
+        notebook.resize(1024, 768);
+        notebook.show();
+        QVERIFY(QTest::qWaitForWindowExposed(&notebook));
+
+        // MainWindow::beginBulkLoad()
+        if (bulk) {
+            for (QWidget *contentList : contentLists) {
+                contentList->setUpdatesEnabled(false);
+                contentList->layout()->setEnabled(false);
+            }
+        }
+
+        for (int i = 0; i < widgets; i++) {
+            PlaybackWidget *playbackWidget = new PlaybackWidget(nullptr);
+            playbackWidget->setChannelMap(m_map, true);
+            playbackWidget->nameLabel->setText(QStringLiteral("Stream %1").arg(i));
+            playbackWidget->setVolume(m_volume);
+            contentLists[i % TAB_COUNT]->layout()->addWidget(playbackWidget);
+
+            QCoreApplication::processEvents();
+        }
+
+        // MainWindow::endBulkLoad()
+        if (bulk) {
+            for (QWidget *contentList : contentLists) {
+                contentList->layout()->setEnabled(true);
+                contentList->layout()->activate();
+                contentList->setUpdatesEnabled(true);
+            }
+        }
+
+        // Up to and including the first paint with everything in it
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(BenchBulkLoad)
+
+#include "bench_bulkload.moc"
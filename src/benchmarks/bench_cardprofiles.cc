@@ -0,0 +1,167 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// Which profiles of a card get marked unplugged, as updateCard() works it
+// out on every card change: the index CardWidget::unpluggedProfiles()
+// builds against the scan of every port for every profile it replaced
+
+#include "cardwidget.h"
+
+#include <QtTest>
+
+#include <algorithm>
+#include <vector>
+
+static const int PROFILES = 100;
+static const int PORTS = 30;
+static const int PROFILES_PER_PORT = 40;
+
+class BenchCardProfiles : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void scan();
+    void index();
+
+private:
+    std::vector<QByteArray> m_names;
+    std::vector<pa_card_profile_info2> m_profiles;
+    std::vector<pa_card_profile_info2 *> m_profilePointers;
+    std::vector<pa_card_port_info> m_ports;
+    std::vector<pa_card_port_info *> m_portPointers;
+    std::vector<std::vector<pa_card_profile_info2 *>> m_portProfiles;
+    pa_card_info m_card;
+
+    // What updateCard() used to search, kept per port
+    std::vector<PortInfo> m_portInfos;
+};
+
+void BenchCardProfiles::initTestCase()
+{
+    m_names.reserve(PROFILES);
+    m_profiles.resize(PROFILES);
+
+    for (int i = 0; i < PROFILES; i++) {
+        m_names.push_back("output:analog-stereo+input:analog-stereo-" + QByteArray::number(i));
+        m_profiles[i] = {};
+        m_profiles[i].name = m_names.back().constData();
+        m_profiles[i].description = m_profiles[i].name;
+        m_profiles[i].available = 1;
+        m_profilePointers.push_back(&m_profiles[i]);
+    }
+
+    m_ports.resize(PORTS);
+    m_portProfiles.resize(PORTS);
+
+    for (int i = 0; i < PORTS; i++) {
+        // A third of them unplugged, sharing some profiles with the rest
+        const bool isUnplugged = i < PORTS / 3;
+        for (int j = 0; j < PROFILES_PER_PORT; j++) {
+            const int profile = isUnplugged ? (i * 4 + j) % 50 : 40 + ((i - PORTS / 3) * 3 + j) % 60;
+            m_portProfiles[i].push_back(&m_profiles[profile]);
+        }
+
+        m_ports[i] = {};
+        m_ports[i].name = "analog-output";
+        m_ports[i].available = isUnplugged ? PA_PORT_AVAILABLE_NO : PA_PORT_AVAILABLE_YES;
+        m_ports[i].n_profiles = PROFILES_PER_PORT;
+        m_ports[i].profiles2 = m_portProfiles[i].data();
+        m_portPointers.push_back(&m_ports[i]);
+
+        PortInfo portInfo;
+        portInfo.available = m_ports[i].available;
+        for (pa_card_profile_info2 *profile : m_portProfiles[i]) {
+            portInfo.profiles.push_back(profile->name);
+        }
+        m_portInfos.push_back(portInfo);
+    }
+
+    m_card = {};
+    m_card.name = "alsa_card.usb-synthetic";
+    m_card.n_profiles = PROFILES;
+    m_card.profiles2 = m_profilePointers.data();
+    m_card.n_ports = PORTS;
+    m_card.ports = m_portPointers.data();
+
+    // Both have to agree before comparing them means anything
+    const QSet<QByteArray> unplugged = CardWidget::unpluggedProfiles(m_card);
+    for (const pa_card_profile_info2 &profile : m_profiles) {
+        bool hasUnavailable = false, hasOther = false;
+        for (const PortInfo &port : m_portInfos) {
+            if (std::find(port.profiles.begin(), port.profiles.end(), profile.name) == port.profiles.end()) {
+                continue;
+            }
+            (port.available == PA_PORT_AVAILABLE_NO ? hasUnavailable : hasOther) = true;
+        }
+
+        QCOMPARE(unplugged.contains(profile.name), hasUnavailable && !hasOther);
+    }
+}
+
+void BenchCardProfiles::scan()
+{
+    int count = 0;
+
+    QBENCHMARK {
+        count = 0;
+
+        for (const pa_card_profile_info2 &profile : m_profiles) {
+            bool hasUnavailable = false, hasOther = false;
+
+            for (const PortInfo &port : m_portInfos) {
+                if (std::find(port.profiles.begin(), port.profiles.end(), profile.name) == port.profiles.end()) {
+                    continue;
+                }
+
+                if (port.available == PA_PORT_AVAILABLE_NO) {
+                    hasUnavailable = true;
+                } else {
+                    hasOther = true;
+                    break;
+                }
+            }
+
+            count += hasUnavailable && !hasOther;
+        }
+    }
+
+    QVERIFY(count > 0);
+}
+
+void BenchCardProfiles::index()
+{
+    int count = 0;
+
+    QBENCHMARK {
+        count = 0;
+
+        const QSet<QByteArray> unplugged = CardWidget::unpluggedProfiles(m_card);
+        for (const pa_card_profile_info2 &profile : m_profiles) {
+            count += unplugged.contains(QByteArray::fromRawData(profile.name, int(strlen(profile.name))));
+        }
+    }
+
+    QVERIFY(count > 0);
+}
+
+QTEST_MAIN(BenchCardProfiles)
+
+#include "bench_cardprofiles.moc"
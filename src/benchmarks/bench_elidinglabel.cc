@@ -0,0 +1,100 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// Repainting 200 stream name labels whose text did not change, as their rows
+// do while the meters next to them animate: the cached layout of ElidingLabel
+// against eliding in every paint as it used to.
+
+#include "elidinglabel.h"
+
+#include <QImage>
+#include <QPainter>
+#include <QStyleOption>
+#include <QtTest>
+
+static const int LABELS = 200;
+
+// ElidingLabel::paintEvent() before the elided layout was cached
+class UncachedElidingLabel : public QLabel {
+public:
+    using QLabel::QLabel;
+
+protected:
+    void paintEvent(QPaintEvent *) override
+    {
+        QPainter painter(this);
+        QStyleOption opt;
+        opt.initFrom(this);
+
+        style()->drawItemText(&painter,
+                opt.rect,
+                alignment(),
+                opt.palette,
+                isEnabled(),
+                opt.fontMetrics.elidedText(text(), Qt::ElideRight, opt.rect.width()),
+                foregroundRole()
+            );
+    }
+};
+
+class BenchElidingLabel : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void paint_data();
+    void paint();
+};
+
+void BenchElidingLabel::paint_data()
+{
+    QTest::addColumn<bool>("cached");
+
+    QTest::newRow("cached") << true;
+    QTest::newRow("uncached") << false;
+}
+
+void BenchElidingLabel::paint()
+{
+    QFETCH(bool, cached);
+
+    QVector<QLabel *> labels;
+    for (int i = 0; i < LABELS; i++) {
+        const QString name = QStringLiteral("Stream %1: a media player playing a rather long track title").arg(i);
+        if (cached) {
+            labels.append(new ElidingLabel(name));
+        } else {
+            labels.append(new UncachedElidingLabel(name));
+        }
+        labels.last()->resize(160, labels.last()->sizeHint().height());
+    }
+
+    QImage image(labels.first()->size(), QImage::Format_ARGB32_Premultiplied);
+
+    QBENCHMARK {
+        for (QLabel *label : labels) {
+            label->render(&image);
+        }
+    }
+
+    qDeleteAll(labels);
+}
+
+QTEST_MAIN(BenchElidingLabel)
+
+#include "bench_elidinglabel.moc"
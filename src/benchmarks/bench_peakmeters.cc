@@ -0,0 +1,105 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// A frame of 200 meters that all got a new peak: the self-painted meters,
+// advanced the way FrameTicker does, against the QProgressBars they replaced.
+// Run with QT_QPA_PLATFORM=offscreen where there is no display.
+
+#include "peakmeter.h"
+
+#include <QProgressBar>
+#include <QVBoxLayout>
+#include <QtTest>
+
+static const int METERS = 200;
+
+class BenchPeakMeters : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void peakMeters();
+    void progressBars();
+};
+
+void BenchPeakMeters::peakMeters()
+{
+    QWidget window;
+    QVBoxLayout *layout = new QVBoxLayout(&window);
+
+    QVector<PeakMeter *> meters;
+    for (int i = 0; i < METERS; i++) {
+        meters.append(new PeakMeter);
+        layout->addWidget(meters.last());
+    }
+
+    window.resize(400, 1000);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    int frame = 0;
+
+    QBENCHMARK {
+        frame++;
+
+        for (int i = 0; i < METERS; i++) {
+            meters[i]->setPeak(((i + frame) % 20) / 20.);
+        }
+
+        const qint64 msecs = FrameTicker::instance()->now();
+        for (PeakMeter *meter : meters) {
+            meter->advanceFrame(msecs);
+        }
+
+        QCoreApplication::processEvents();
+    }
+}
+
+void BenchPeakMeters::progressBars()
+{
+    QWidget window;
+    QVBoxLayout *layout = new QVBoxLayout(&window);
+
+    QVector<QProgressBar *> bars;
+    for (int i = 0; i < METERS; i++) {
+        bars.append(new QProgressBar);
+        bars.last()->setTextVisible(false);
+        bars.last()->setMaximum(1000);
+        layout->addWidget(bars.last());
+    }
+
+    window.resize(400, 1000);
+    window.show();
+    QVERIFY(QTest::qWaitForWindowExposed(&window));
+
+    int frame = 0;
+
+    QBENCHMARK {
+        frame++;
+
+        for (int i = 0; i < METERS; i++) {
+            bars[i]->setValue(((i + frame) % 20) * 50);
+        }
+
+        QCoreApplication::processEvents();
+    }
+}
+
+QTEST_MAIN(BenchPeakMeters)
+
+#include "bench_peakmeters.moc"
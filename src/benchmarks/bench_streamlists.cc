@@ -0,0 +1,132 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// The Playback tab with as many streams as widgets and as compact rows,
+// from nothing to laid out and painted once
+
+#include "playbackwidget.h"
+#include "streamlistmodel.h"
+#include "streamlistview.h"
+
+#include <QScrollArea>
+#include <QVBoxLayout>
+#include <QtTest>
+
+class BenchStreamLists : public QObject
+{
+    Q_OBJECT
+
+private Q_SLOTS:
+    void initTestCase();
+
+    void widgets_data();
+    void widgets();
+    void compact_data();
+    void compact();
+
+private:
+    pa_channel_map m_map;
+    pa_cvolume m_volume;
+};
+
+void BenchStreamLists::initTestCase()
+{
+    pa_channel_map_init_stereo(&m_map);
+    pa_cvolume_set(&m_volume, m_map.channels, PA_VOLUME_NORM);
+}
+
+static void addStreamCounts()
+{
+    QTest::addColumn<int>("streams");
+
+    QTest::newRow("50") << 50;
+    QTest::newRow("200") << 200;
+    QTest::newRow("500") << 500;
+}
+
+void BenchStreamLists::widgets_data()
+{
+    addStreamCounts();
+}
+
+void BenchStreamLists::widgets()
+{
+    QFETCH(int, streams);
+
+    int objects = 0;
+
+    QBENCHMARK {
+        QScrollArea area;
+        QWidget *box = new QWidget;
+        QVBoxLayout *layout = new QVBoxLayout(box);
+
+        for (int i = 0; i < streams; i++) {
+            PlaybackWidget *playbackWidget = new PlaybackWidget(nullptr);
+            playbackWidget->setChannelMap(m_map, true);
+            playbackWidget->nameLabel->setText(QStringLiteral("Stream %1").arg(i));
+            playbackWidget->setVolume(m_volume);
+            layout->addWidget(playbackWidget);
+        }
+
+        area.setWidgetResizable(true);
+        area.setWidget(box);
+        area.resize(600, 800);
+        area.grab();
+
+        objects = area.findChildren<QObject *>().size();
+    }
+
+    qInfo() << streams << "streams as widgets:" << objects << "objects";
+}
+
+void BenchStreamLists::compact_data()
+{
+    addStreamCounts();
+}
+
+void BenchStreamLists::compact()
+{
+    QFETCH(int, streams);
+
+    int objects = 0;
+
+    QBENCHMARK {
+        StreamListModel model(StreamListModel::Playback);
+        StreamListView view;
+        view.setModel(&model);
+
+        for (int i = 0; i < streams; i++) {
+            StreamListModel::Stream stream;
+            stream.index = uint32_t(i);
+            stream.name = QStringLiteral("Stream %1").arg(i);
+            stream.volume = m_volume;
+            model.updateStream(stream);
+        }
+
+        view.resize(600, 800);
+        view.grab();
+
+        objects = view.findChildren<QObject *>().size();
+    }
+
+    qInfo() << streams << "streams as compact rows:" << objects << "objects";
+}
+
+QTEST_MAIN(BenchStreamLists)
+
+#include "bench_streamlists.moc"
@@ -0,0 +1,54 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+// What pavucontrol.cc provides next to main(). The benchmarks run without a
+// server, nothing in them may get as far as sending anything.
+
+#include "pavucontrol.h"
+
+#include <QDebug>
+
+pa_context *get_context()
+{
+    return nullptr;
+}
+
+void show_error(const char *txt)
+{
+    qWarning() << txt;
+}
+
+void sink_cb(pa_context *, const pa_sink_info *, int, void *)
+{
+}
+
+void source_cb(pa_context *, const pa_source_info *, int, void *)
+{
+}
+
+void card_cb(pa_context *, const pa_card_info *, int, void *)
+{
+}
+
+void sink_input_cb(pa_context *, const pa_sink_input_info *, int, void *)
+{
+}
+
+void source_output_cb(pa_context *, const pa_source_output_info *, int, void *)
+{
+}
@@ -26,6 +26,9 @@
 #include <QCheckBox>
 
 #include "minimalstreamwidget.h"
+#include "combosync.h"
+
+#include <cstring>
 
 /*** CardWidget ***/
 CardWidget::CardWidget(QWidget *parent) :
@@ -65,31 +68,22 @@ CardWidget::CardWidget(QWidget *parent) :
 
 void CardWidget::prepareMenu()
 {
-    int idx = 0;
     const bool off = activeProfile == noInOutProfile;
 
-    profileList->clear();
-
-    /* Fill the ComboBox */
-    for (const std::pair<QByteArray, QByteArray> &profile : profiles) {
-        QByteArray name = profile.first;
-
+    // Most updates don't touch the profiles, cards with lots of them
+    // (HDMI plus analog combinations) would otherwise rebuild the combo
+    // every time
+    if (profiles != shownProfiles || noInOutProfile != shownNoInOutProfile) {
         // skip the "off" profile
-        if (name == noInOutProfile) {
-            continue;
-        }
-
-        QString desc = QString::fromUtf8(profile.second);
-        profileList->addItem(desc, name);
-
-        if (profile.first == activeProfile
-                || (off && profile.first == lastActiveProfile)
-           ) {
-            profileList->setCurrentIndex(idx);
-            lastActiveProfile = profile.first;
-        }
+        syncComboItems(profileList, profiles, noInOutProfile);
+        shownProfiles = profiles;
+        shownNoInOutProfile = noInOutProfile;
+    }
 
-        ++idx;
+    const int idx = profileList->findData(off ? lastActiveProfile : activeProfile);
+    if (idx >= 0) {
+        profileList->setCurrentIndex(idx);
+        lastActiveProfile = profileList->itemData(idx).toByteArray();
     }
 
     profileCB->setChecked(!off);
@@ -105,6 +99,8 @@ void CardWidget::changeProfile(const QByteArray &name)
     }
 
     pa_operation_unref(o);
+
+    Q_EMIT profileEdited(activeProfile, name);
 }
 
 void CardWidget::onProfileChange(int active)
@@ -131,3 +127,30 @@ void CardWidget::onProfileCheck(bool on)
     }
 
 }
+
+QSet<QByteArray> CardWidget::unpluggedProfiles(const pa_card_info &info)
+{
+    // Whether each profile has ports that are unplugged and/or ports that
+    // aren't
+    enum { PROFILE_PORT_UNPLUGGED = 1, PROFILE_PORT_OTHER = 2 };
+    QHash<QByteArray, int> profilePorts;
+    profilePorts.reserve(int(info.n_profiles));
+
+    for (uint32_t i = 0; i < info.n_ports; ++i) {
+        const int portState = info.ports[i]->available == PA_PORT_AVAILABLE_NO ? PROFILE_PORT_UNPLUGGED : PROFILE_PORT_OTHER;
+
+        for (uint32_t j = 0; j < info.ports[i]->n_profiles; j++) {
+            const char *profileName = info.ports[i]->profiles2[j]->name;
+            profilePorts[QByteArray::fromRawData(profileName, int(strlen(profileName)))] |= portState;
+        }
+    }
+
+    QSet<QByteArray> unplugged;
+    for (auto it = profilePorts.constBegin(); it != profilePorts.constEnd(); ++it) {
+        if (it.value() == PROFILE_PORT_UNPLUGGED) {
+            unplugged.insert(it.key());
+        }
+    }
+
+    return unplugged;
+}
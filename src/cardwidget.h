@@ -23,6 +23,7 @@
 
 #include "pavucontrol.h"
 #include <QGroupBox>
+#include <QSet>
 
 class QLabel;
 class QCheckBox;
@@ -47,16 +48,14 @@ public:
     CardWidget(QWidget *parent = nullptr);
 
     QString name;
+    QByteArray cardName;    // the server's, name is what's shown
     uint32_t index;
     bool updating;
 
     std::vector< std::pair<QByteArray, QByteArray>> profiles;
-    QHash<QByteArray, PortInfo> ports;
     QByteArray activeProfile;
     QByteArray noInOutProfile;
     QByteArray lastActiveProfile;
-    bool hasOutputs = false;
-    bool hasSources = false;
 
     QLabel *iconImage;
     QLabel *nameLabel;
@@ -65,11 +64,26 @@ public:
 
     void prepareMenu();
 
+    // Profiles all of whose ports are unplugged. Built in one pass over the
+    // ports instead of searching every port again for every profile, jack
+    // events on USB and HDMI cards make updateCard() run a lot. The names
+    // point into info.
+    static QSet<QByteArray> unpluggedProfiles(const pa_card_info &info);
+
+Q_SIGNALS:
+    // The user picked another profile, for the journal
+    void profileEdited(const QByteArray &before, const QByteArray &after);
+
 protected:
     void changeProfile(const QByteArray &name);
     void onProfileChange(int active);
     void onProfileCheck(bool on);
 
+private:
+    // What profileList currently shows
+    std::vector< std::pair<QByteArray, QByteArray>> shownProfiles;
+    QByteArray shownNoInOutProfile;
+
 };
 
 #endif
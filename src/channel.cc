@@ -20,6 +20,8 @@
 #include "channel.h"
 
 #include "minimalstreamwidget.h"
+#include "peakmeter.h"
+#include "elidinglabel.h"
 
 #include <QGridLayout>
 #include <QLabel>
@@ -30,6 +32,9 @@
 #include <QStyleOptionSlider>
 #include <QMouseEvent>
 #include <QContextMenuEvent>
+#include <QResizeEvent>
+#include <QLocale>
+#include <QVector>
 
 constexpr int SLIDER_SNAP = 2;
 static inline int paVolume2Percent(pa_volume_t vol)
@@ -46,30 +51,139 @@ static inline pa_volume_t percent2PaVolume(int percent)
     return PA_VOLUME_MUTED + qRound(static_cast<double>(percent) / 100 * PA_VOLUME_NORM);
 }
 
+static QString formatVolumeLabel(pa_volume_t volume, bool decibel)
+{
+    const int v = paVolume2Percent(volume);
+
+    if (!decibel) {
+        return Channel::tr("%1%", "volume slider label [X%]").arg(v);
+    }
+
+    const double dB = pa_sw_volume_to_dB(volume);
+    return Channel::tr("%1% (%2dB)", "volume slider label [X% (YdB)]").arg(v)
+        .arg(dB > PA_DECIBEL_MININFTY ? QString::asprintf("%0.2f", dB) : QStringLiteral("-\u221E"));
+}
+
+// The label for every step of the slider, so dragging it only looks strings
+// up instead of formatting (and translating) one per step and channel
+static const QVector<QString> &volumeLabels(bool decibel)
+{
+    static QLocale locale;
+    static QVector<QString> labels[2];
+
+    if (QLocale() != locale) {
+        locale = QLocale();
+        labels[0].clear();
+        labels[1].clear();
+    }
+
+    QVector<QString> &table = labels[decibel];
+    if (table.isEmpty()) {
+        const int maximum = paVolume2Percent(PA_VOLUME_UI_MAX);
+        table.reserve(maximum + 1);
+        for (int percent = 0; percent <= maximum; percent++) {
+            table.append(formatVolumeLabel(percent2PaVolume(percent), decibel));
+        }
+    }
+
+    return table;
+}
+
 NotchedSlider::NotchedSlider(Qt::Orientation orientation, QWidget *parent) :
     QSlider(orientation, parent)
 {}
 
-void NotchedSlider::paintEvent(QPaintEvent *e)
+void NotchedSlider::setMarks(const QVector<int> &values)
 {
+    if (values == m_marks) {
+        return;
+    }
+
+    m_marks = values;
+    m_marksPixmap = QPixmap();
+    update();
+}
+
+void NotchedSlider::renderOverlays()
+{
+    const qreal dpr = devicePixelRatioF();
+
+    QStyleOptionSlider options;
+    initStyleOption(&options);
+    options.subControls = QStyle::SC_SliderHandle;
+    options.state = QStyle::State_Enabled | QStyle::State_Horizontal | QStyle::State_Active;
+
     // Indicate the default 100% value
-    const int defaultValue = paVolume2Percent(PA_VOLUME_NORM);
-    if (value() != defaultValue) {
-        QStyleOptionSlider options;
-        initStyleOption(&options);
-        options.subControls = QStyle::SC_SliderHandle;
-        options.sliderValue = defaultValue;
+    if (m_notch.isNull()) {
+        options.sliderValue = paVolume2Percent(PA_VOLUME_NORM);
         options.sliderPosition = options.sliderValue;
-        options.state = QStyle::State_Enabled | QStyle::State_Horizontal | QStyle::State_Active;
 
-        QPainter p(this);
+        m_notch = QPixmap(size() * dpr);
+        m_notch.setDevicePixelRatio(dpr);
+        m_notch.fill(Qt::transparent);
+
+        QPainter p(&m_notch);
         p.setOpacity(0.9);
         style()->drawComplexControl(QStyle::CC_Slider, &options, &p, this);
     }
 
+    if (m_marksPixmap.isNull() && !m_marks.isEmpty()) {
+        m_marksPixmap = QPixmap(size() * dpr);
+        m_marksPixmap.setDevicePixelRatio(dpr);
+        m_marksPixmap.fill(Qt::transparent);
+
+        QPainter p(&m_marksPixmap);
+        p.setPen(palette().color(QPalette::WindowText));
+
+        const int tickLength = qMax(2, height() / 6);
+        for (int mark : m_marks) {
+            options.sliderValue = mark;
+            options.sliderPosition = mark;
+
+            const QRect handle = style()->subControlRect(QStyle::CC_Slider, &options, QStyle::SC_SliderHandle, this);
+            p.drawLine(handle.center().x(), height() - tickLength, handle.center().x(), height() - 1);
+        }
+    }
+}
+
+void NotchedSlider::paintEvent(QPaintEvent *e)
+{
+    renderOverlays();
+
+    QPainter p(this);
+    if (value() != paVolume2Percent(PA_VOLUME_NORM)) {
+        p.drawPixmap(0, 0, m_notch);
+    }
+    if (!m_marks.isEmpty()) {
+        p.drawPixmap(0, 0, m_marksPixmap);
+    }
+    p.end();
+
     QSlider::paintEvent(e);
 }
 
+void NotchedSlider::resizeEvent(QResizeEvent *event)
+{
+    m_notch = m_marksPixmap = QPixmap();
+    QSlider::resizeEvent(event);
+}
+
+void NotchedSlider::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::StyleChange || event->type() == QEvent::PaletteChange) {
+        m_notch = m_marksPixmap = QPixmap();
+    }
+    QSlider::changeEvent(event);
+}
+
+void NotchedSlider::sliderChange(SliderChange change)
+{
+    if (change == SliderRangeChange) {
+        m_notch = m_marksPixmap = QPixmap();
+    }
+    QSlider::sliderChange(change);
+}
+
 void NotchedSlider::mouseReleaseEvent(QMouseEvent *event)
 {
     if (event->button() != Qt::RightButton) {
@@ -98,13 +212,22 @@ Channel::Channel(QVBoxLayout *parent) :
 {
     channelLabel = new QLabel(nullptr);
     volumeScale = new NotchedSlider(Qt::Horizontal, nullptr);
-    volumeLabel = new QLabel(nullptr);
+    volumeLabel = new ElidingLabel(QString(), nullptr);
+    peakMeter = new PeakMeter(nullptr);
+    peakMeter->hide();
 
 //    const int row = parent->rowCount();
     QHBoxLayout *row = new QHBoxLayout;
     parent->addLayout(row);
     row->addWidget(channelLabel);
-    row->addWidget(volumeScale);
+
+    // The per-channel meter goes right below the slider
+    QVBoxLayout *scaleColumn = new QVBoxLayout;
+    scaleColumn->setSpacing(0);
+    scaleColumn->addWidget(volumeScale);
+    scaleColumn->addWidget(peakMeter);
+    row->addLayout(scaleColumn);
+
     row->addWidget(volumeLabel);
 
     // make the info font smaller
@@ -119,7 +242,7 @@ Channel::Channel(QVBoxLayout *parent) :
     volumeLabel->setFont(label_font);
     volumeLabel->setFixedWidth(QFontMetrics{volumeLabel->font()}.size(Qt::TextSingleLine, QStringLiteral("100%(-99.99dB)")).width());
     volumeLabel->setAlignment(Qt::AlignHCenter);
-    volumeLabel->setTextFormat(Qt::RichText);
+    volumeLabel->setTextFormat(Qt::PlainText);
 
     volumeScale->setRange(paVolume2Percent(PA_VOLUME_MUTED), paVolume2Percent(PA_VOLUME_UI_MAX));
     volumeScale->setValue(paVolume2Percent(PA_VOLUME_NORM));
@@ -134,12 +257,12 @@ void Channel::setVolume(pa_volume_t volume)
 {
     const int v = paVolume2Percent(volume);
 
-    if (can_decibel) {
-        const double dB = pa_sw_volume_to_dB(volume);
-        volumeLabel->setText(tr("%1% (%2dB)", "volume slider label [X% (YdB)]").arg(v)
-                             .arg(dB > PA_DECIBEL_MININFTY ? QString::asprintf("%0.2f", dB) : QStringLiteral("-&#8734;")));
+    // Volumes set elsewhere don't have to be on a whole percent, those
+    // still get their exact dB
+    if (volume == percent2PaVolume(v)) {
+        volumeLabel->setText(volumeLabels(can_decibel).at(v));
     } else {
-        volumeLabel->setText(tr("%1%", "volume slider label [X%]").arg(v));
+        volumeLabel->setText(formatVolumeLabel(volume, can_decibel));
     }
 
     const QSignalBlocker blocker(volumeScale);
@@ -148,9 +271,35 @@ void Channel::setVolume(pa_volume_t volume)
 
 void Channel::setVisible(bool visible)
 {
-    channelLabel->setVisible(visible);
-    volumeScale->setVisible(visible);
-    volumeLabel->setVisible(visible);
+    m_visible = visible;
+    updateVisibility();
+}
+
+void Channel::setLabelVisible(bool visible)
+{
+    m_labelVisible = visible;
+    updateVisibility();
+}
+
+void Channel::setMeterVisible(bool visible)
+{
+    m_meterVisible = visible;
+    updateVisibility();
+}
+
+void Channel::updateVisibility()
+{
+    // With per-channel meters the row stays around for the meter even when
+    // the channels are locked together and the slider is hidden
+    channelLabel->setVisible((m_visible && m_labelVisible) || m_meterVisible);
+    volumeScale->setVisible(m_visible);
+    peakMeter->setVisible(m_meterVisible);
+
+    // Keep the meters of all rows the same width
+    QSizePolicy labelPolicy = volumeLabel->sizePolicy();
+    labelPolicy.setRetainSizeWhenHidden(m_meterVisible);
+    volumeLabel->setSizePolicy(labelPolicy);
+    volumeLabel->setVisible(m_visible);
 }
 
 void Channel::setEnabled(bool enabled)
@@ -197,21 +346,14 @@ void Channel::set_sensitive(bool enabled) {
 }
 */
 
-void Channel::setBaseVolume(pa_volume_t /*v*/)
+void Channel::setBaseVolume(pa_volume_t v)
 {
-#if 0  // FIXME: Qt does not support this functionality
-    gtk_scale_clear_marks(GTK_SCALE(volumeScale->gobj()));
-
-    gtk_scale_add_mark(GTK_SCALE(volumeScale->gobj()), (double)PA_VOLUME_MUTED, (GtkPositionType) GTK_POS_BOTTOM,
-                       last ? (can_decibel ? tr("<small>Silence</small>").toUtf8().constData() : tr("<small>Min</small>").toUtf8().constData()) : NULL);
-    gtk_scale_add_mark(GTK_SCALE(volumeScale->gobj()), (double)PA_VOLUME_NORM, (GtkPositionType) GTK_POS_BOTTOM,
-                       last ? tr("<small>100% (0dB)</small>").toUtf8().constData() : NULL);
-
+    // 0 dB, and the device's base volume (its unamplified hardware level)
+    // when that is lower
+    QVector<int> marks({ paVolume2Percent(PA_VOLUME_NORM) });
     if (v > PA_VOLUME_MUTED && v < PA_VOLUME_NORM) {
-        gtk_scale_add_mark(GTK_SCALE(volumeScale->gobj()), (double)v, (GtkPositionType) GTK_POS_BOTTOM,
-                           last ? tr("<small><i>Base</i></small>").toUtf8().constData() : NULL);
+        marks.append(paVolume2Percent(v));
     }
 
-#endif
-
+    volumeScale->setMarks(marks);
 }
@@ -23,12 +23,15 @@
 
 #include <QObject>
 #include <QSlider>
+#include <QPixmap>
+#include <QVector>
 #include "pavucontrol.h"
 
 class QVBoxLayout;
 class QLabel;
 class QSlider;
 class MinimalStreamWidget;
+class PeakMeter;
 
 class NotchedSlider : public QSlider
 {
@@ -37,10 +40,26 @@ class NotchedSlider : public QSlider
 public:
     NotchedSlider(Qt::Orientation orientation, QWidget *parent = nullptr);
 
+    // Small ticks below the groove, e.g. for 0 dB and the base volume
+    void setMarks(const QVector<int> &values);
+
 protected:
     void paintEvent(QPaintEvent *e) override;
+    void resizeEvent(QResizeEvent *event) override;
+    void changeEvent(QEvent *event) override;
+    void sliderChange(SliderChange change) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
+
+private:
+    void renderOverlays();
+
+    QVector<int> m_marks;
+
+    // The notch and the marks only change with the size, style, palette or
+    // range, so they are drawn once instead of on every paint
+    QPixmap m_notch;
+    QPixmap m_marksPixmap;
 };
 
 class Channel : public QObject
@@ -51,6 +70,8 @@ public:
 
     void setVolume(pa_volume_t volume);
     void setVisible(bool visible);
+    void setLabelVisible(bool visible);
+    void setMeterVisible(bool visible);
     void setEnabled(bool enabled);
 
     int channel;
@@ -67,9 +88,17 @@ public:
     QLabel *channelLabel;
     NotchedSlider *volumeScale;
     QLabel *volumeLabel;
+    PeakMeter *peakMeter;
 
     //virtual void set_sensitive(bool enabled);
     virtual void setBaseVolume(pa_volume_t);
+
+private:
+    void updateVisibility();
+
+    bool m_visible = true;
+    bool m_labelVisible = true;
+    bool m_meterVisible = false;
 };
 
 
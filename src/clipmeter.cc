@@ -0,0 +1,60 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "clipmeter.h"
+
+ClipMeter::ClipMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent) :
+    MonitorTap(parent)
+{
+    start(tr("Clip detection"), source, stream, map);
+}
+
+ClipMeter::~ClipMeter()
+{
+    stop();
+}
+
+// The worker's counts only ever grow, resetting just moves the baseline
+void ClipMeter::reset()
+{
+    m_clippedBase = m_clipped;
+    m_flatTopsBase = m_flatTops;
+    Q_EMIT countsChanged();
+}
+
+void ClipMeter::configure(const pa_sample_spec &spec, const pa_channel_map &)
+{
+    m_channels = spec.channels;
+    m_detector.reset();
+}
+
+bool ClipMeter::analyze(const float *samples, size_t frames)
+{
+    return m_detector.process(samples, frames, m_channels);
+}
+
+void ClipMeter::publish()
+{
+    const unsigned long long clipped = m_detector.clipped();
+    const unsigned long long flatTops = m_detector.flatTops();
+
+    QMetaObject::invokeMethod(this, [this, clipped, flatTops] {
+        m_clipped = clipped;
+        m_flatTops = flatTops;
+        Q_EMIT countsChanged();
+    });
+}
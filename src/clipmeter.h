@@ -0,0 +1,55 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "monitortap.h"
+#include "meterdsp.h"
+
+// Clipped samples and flat tops of a source or sink input, counted at the
+// full sample rate, see meterdsp::ClipDetector
+class ClipMeter : public MonitorTap
+{
+    Q_OBJECT
+
+public:
+    ClipMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent = nullptr);
+    ~ClipMeter() override;
+
+    // Since the last reset()
+    unsigned long long clipped() const { return m_clipped - m_clippedBase; }
+    unsigned long long flatTops() const { return m_flatTops - m_flatTopsBase; }
+    void reset();
+
+Q_SIGNALS:
+    void countsChanged();
+
+protected:
+    void configure(const pa_sample_spec &spec, const pa_channel_map &map) override;
+    bool analyze(const float *samples, size_t frames) override;
+    void publish() override;
+
+private:
+    // Worker thread only
+    meterdsp::ClipDetector m_detector;
+    unsigned m_channels = 0;
+
+    unsigned long long m_clipped = 0;
+    unsigned long long m_flatTops = 0;
+    unsigned long long m_clippedBase = 0;
+    unsigned long long m_flatTopsBase = 0;
+};
@@ -0,0 +1,50 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "combosync.h"
+
+#include <QComboBox>
+
+void syncComboItems(QComboBox *combo, const std::vector<std::pair<QByteArray, QByteArray>> &items, const QByteArray &skip)
+{
+    int row = 0;
+
+    for (const std::pair<QByteArray, QByteArray> &item : items) {
+        if (!skip.isEmpty() && item.first == skip) {
+            continue;
+        }
+
+        const QString text = QString::fromUtf8(item.second);
+        if (row < combo->count()) {
+            if (combo->itemData(row).toByteArray() != item.first) {
+                combo->setItemData(row, item.first);
+            }
+            if (combo->itemText(row) != text) {
+                combo->setItemText(row, text);
+            }
+        } else {
+            combo->addItem(text, item.first);
+        }
+
+        row++;
+    }
+
+    while (combo->count() > row) {
+        combo->removeItem(combo->count() - 1);
+    }
+}
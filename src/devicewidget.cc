@@ -21,7 +21,9 @@
 #include "devicewidget.h"
 
 #include "mainwindow.h"
+#include "operationbatch.h"
 #include "channel.h"
+#include "combosync.h"
 
 #include <sstream>
 #include <QAction>
@@ -37,6 +39,7 @@
 #include <QCoreApplication>
 #include <QGroupBox>
 #include <QDebug>
+#include <QPointer>
 
 #include <pulse/ext-device-manager.h>
 
@@ -44,6 +47,7 @@
 DeviceWidget::DeviceWidget(MainWindow *parent, const QByteArray &deviceType) :
     MinimalStreamWidget(parent),
     offsetButtonEnabled(false),
+    volumeWriter([this]() { executeVolumeUpdate(); }),
     mpMainWindow(parent),
     rename{new QAction{tr("Rename device..."), this}},
        mDeviceType(QString::fromUtf8(deviceType))
@@ -105,11 +109,7 @@ DeviceWidget::DeviceWidget(MainWindow *parent, const QByteArray &deviceType) :
 
     mainLayout->addWidget(advancedWidget);
 
-    initPeakProgressBar(channelsList);
-
-    timeout.setSingleShot(true);
-    timeout.setInterval(100);
-    connect(&timeout, &QTimer::timeout, this, &DeviceWidget::timeoutEvent);
+    initPeakMeter(channelsList);
 
     connect(muteToggleButton, &QToolButton::toggled, this, &DeviceWidget::onMuteToggleButton);
     connect(lockToggleButton, &QToolButton::toggled, this, &DeviceWidget::onLockToggleButton);
@@ -123,10 +123,6 @@ DeviceWidget::DeviceWidget(MainWindow *parent, const QByteArray &deviceType) :
     connect(portList, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &DeviceWidget::onPortChange);
     connect(offsetButton, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), this, &DeviceWidget::onOffsetChange);
 
-    for (size_t i=0; i<PA_CHANNELS_MAX; i++) {
-        channels[i] = nullptr;
-    }
-
 
     offsetButton->setMaximum(2000);
     offsetButton->setMinimum(-2000);
@@ -149,6 +145,7 @@ void DeviceWidget::setChannelMap(const pa_channel_map &m, bool can_decibel)
 
     lockToggleButton->setEnabled(m.channels > 1);
     hideLockedChannels(lockToggleButton->isChecked());
+    updateMeterVisibility();
 }
 
 void DeviceWidget::setVolume(const pa_cvolume &v, bool force)
@@ -157,7 +154,7 @@ void DeviceWidget::setVolume(const pa_cvolume &v, bool force)
 
     volume = v;
 
-    if (!timeout.isActive() || force) { /* do not update the volume when a volume change is still in flux */
+    if ((!volumeWriter.isBusy() && !volumeFade.isRunning()) || force) { /* do not update the volume when a volume change is still in flux */
         for (int i = 0; i < volume.channels; i++) {
             channels[i]->setVolume(volume.values[i]);
         }
@@ -169,6 +166,9 @@ void DeviceWidget::updateChannelVolume(int channel, pa_volume_t v)
     pa_cvolume n;
     Q_ASSERT(channel < volume.channels);
 
+    // The user takes over, a mute fading out still gets its mute
+    volumeFade.finish();
+
     n = volume;
 
     if (lockToggleButton->isChecked()) {
@@ -177,10 +177,87 @@ void DeviceWidget::updateChannelVolume(int channel, pa_volume_t v)
         n.values[channel] = v;
     }
 
+    const pa_cvolume before = volume;
     setVolume(n, true);
 
-    if (!timeout.isActive()) {
-        timeout.start();
+    volumeWriter.write();
+
+    Q_EMIT volumeEdited(before);
+}
+
+void DeviceWidget::fadeTo(const pa_cvolume &target, int msecs, const std::function<void()> &done)
+{
+    Q_ASSERT(target.channels == volume.channels);
+
+    volumeFade.finish();
+    volumeFade.start(volume, target, msecs, [this](const pa_cvolume &v) {
+        setVolume(v, true);
+        volumeWriter.write();
+    }, done);
+}
+
+void DeviceWidget::applyMute(OperationBatch *batch)
+{
+    if (!batch) {
+        Q_EMIT muteEdited();
+
+        // The rest of the selection follows along, this widget included
+        if (isSelected()) {
+            return;
+        }
+    }
+
+    volumeFade.finish();
+
+    // Taken now, the button follows the server while the fade runs
+    const bool mute = muteToggleButton->isChecked();
+    const unsigned serial = ++muteSerial;
+
+    const int msecs = VolumeFade::muteDuration();
+    if (msecs <= 0 || pa_cvolume_is_muted(&volume)) {
+        executeMuteUpdate(mute, batch);
+        return;
+    }
+
+    // The sliders keep showing the volume we come back to
+    const pa_cvolume target = volume;
+    pa_cvolume silent = volume;
+    pa_cvolume_mute(&silent, silent.channels);
+
+    const VolumeFade::StepFunction step = [this](const pa_cvolume &v) {
+        volume = v;
+        volumeWriter.write();
+    };
+
+    // The mute goes out once the writer has caught up, the batch waits
+    const QPointer<OperationBatch> deferredBatch(batch);
+    const OperationBatch::Hold hold = batch ? batch->hold() : OperationBatch::Hold();
+
+    if (mute) {
+        // Silence, the mute, then the volume to come back to
+        volumeFade.start(target, silent, msecs, step, [this, serial, target, deferredBatch, hold]() {
+            volumeWriter.whenWritten([this, serial, target, deferredBatch, hold]() {
+                if (serial != muteSerial) {
+                    return;
+                }
+
+                executeMuteUpdate(true, deferredBatch);
+                volume = target;
+                volumeWriter.write();
+            });
+        });
+    } else {
+        // Silence before the unmute, then faded in
+        volume = silent;
+        volumeWriter.write();
+        volumeWriter.whenWritten([this, serial, silent, target, msecs, step, deferredBatch, hold]() {
+            if (serial != muteSerial) {
+                return;
+            }
+
+            executeMuteUpdate(false, deferredBatch);
+            volumeFade.start(silent, target, msecs, step);
+        });
     }
 }
 
@@ -190,7 +267,7 @@ void DeviceWidget::hideLockedChannels(bool hide)
         channels[i]->setVisible(!hide);
     }
 
-    channels[channelMap.channels - 1]->channelLabel->setVisible(!hide);
+    channels[channelMap.channels - 1]->setLabelVisible(!hide);
 }
 
 void DeviceWidget::onMuteToggleButton()
@@ -238,12 +315,6 @@ void DeviceWidget::setDefault(bool isDefault)
     /*defaultToggleButton->setEnabled(!isDefault);*/
 }
 
-bool DeviceWidget::timeoutEvent()
-{
-    executeVolumeUpdate();
-    return false;
-}
-
 void DeviceWidget::setLatencyOffset(int64_t offset)
 {
     offsetButtonEnabled = false;
@@ -261,24 +332,13 @@ void DeviceWidget::setBaseVolume(pa_volume_t v)
 
 void DeviceWidget::prepareMenu()
 {
-    int idx = 0;
-    int active_idx = -1;
-
-    portList->clear();
-
-    /* Fill the ComboBox's Model */
-    for (const std::pair<QByteArray, QByteArray> &port : ports) {
-        QByteArray name = port.first;
-        QString desc = QString::fromUtf8(port.second);
-        portList->addItem(desc, name);
-
-        if (port.first == activePort) {
-            active_idx = idx;
-        }
-
-        idx++;
+    // Most updates are about the volume, leave the combo alone then
+    if (ports != shownPorts) {
+        syncComboItems(portList, ports);
+        shownPorts = ports;
     }
 
+    const int active_idx = portList->findData(activePort);
     if (active_idx >= 0) {
         portList->setCurrentIndex(active_idx);
     }
@@ -24,11 +24,14 @@
 #include "pavucontrol.h"
 
 #include "minimalstreamwidget.h"
+#include "volumefade.h"
+#include "volumewriter.h"
 #include <QTimer>
 #include <vector>
 
 class MainWindow;
 class Channel;
+class OperationBatch;
 class QAction;
 class QSpinBox;
 class QCheckBox;
@@ -46,17 +49,22 @@ public:
 
     void hideLockedChannels(bool hide = true);
 
+    // Ramps the volume to target, moving the sliders along. done runs once
+    // the last step has been handed to the writer.
+    void fadeTo(const pa_cvolume &target, int msecs, const std::function<void()> &done = {});
+
+    // Sends the mute button's state, fading out before or in after it.
+    // Without a batch a selected widget leaves it to the selection.
+    void applyMute(OperationBatch *batch = nullptr);
+
     QString name;
     QByteArray description;
     uint32_t index, card_index;
 
     bool offsetButtonEnabled;
 
-    pa_channel_map channelMap;
     pa_cvolume volume;
 
-    Channel *channels[PA_CHANNELS_MAX];
-
 public Q_SLOTS:
     virtual void onMuteToggleButton();
     virtual void onLockToggleButton();
@@ -65,16 +73,27 @@ public Q_SLOTS:
     // virtual bool onContextTriggerEvent(GdkEventButton*);
     virtual void setLatencyOffset(int64_t offset);
     void onOffsetChange();
-    bool timeoutEvent();
+
+Q_SIGNALS:
+    // The user picked another port or made this the default, for the journal
+    void portEdited(const QByteArray &before, const QByteArray &after);
+    void defaultEdited();
 
 public:
-    QTimer timeout;
+    VolumeWriter volumeWriter;
+    VolumeFade volumeFade;
+    // Bumped by every applyMute(), a deferred mute that has been overtaken
+    // by a newer one is dropped
+    unsigned muteSerial = 0;
 
     virtual void executeVolumeUpdate() = 0;
+    virtual void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr) = 0;
     virtual void setBaseVolume(pa_volume_t v);
 
     std::vector< std::pair<QByteArray, QByteArray>> ports;
     QByteArray activePort;
+    // What portList currently shows
+    std::vector< std::pair<QByteArray, QByteArray>> shownPorts;
     QSpinBox *offsetButton;
     QToolButton *defaultToggleButton;
 
@@ -34,12 +34,27 @@ void ElidingLabel::paintEvent(QPaintEvent *)
     QStyleOption opt;
     opt.initFrom(this);
 
-    style()->drawItemText(&painter,
-            opt.rect,
-            alignment(),
-            opt.palette,
-            isEnabled(),
-            opt.fontMetrics.elidedText(text(), Qt::ElideRight, opt.rect.width()),
-            foregroundRole()
-        );
+    const QString label = text();
+    if (label != m_elidedText || opt.rect.width() != m_elidedWidth || font() != m_elidedFont) {
+        m_elidedText = label;
+        m_elidedWidth = opt.rect.width();
+        m_elidedFont = font();
+
+        m_elided.setTextFormat(Qt::PlainText);
+        m_elided.setPerformanceHint(QStaticText::AggressiveCaching);
+        m_elided.setText(opt.fontMetrics.elidedText(label, Qt::ElideRight, m_elidedWidth));
+        m_elided.prepare(QTransform(), m_elidedFont);
+    }
+
+    // Disabled labels do not animate, leave them to the style as it may etch them
+    if (!isEnabled()) {
+        style()->drawItemText(&painter, opt.rect, alignment(), opt.palette, false, m_elided.text(), foregroundRole());
+        return;
+    }
+
+    const QRect textRect = QStyle::alignedRect(layoutDirection(), QStyle::visualAlignment(layoutDirection(), alignment()),
+            m_elided.size().toSize(), opt.rect);
+
+    painter.setPen(QPen(opt.palette.brush(foregroundRole())));
+    painter.drawStaticText(textRect.topLeft(), m_elided);
 }
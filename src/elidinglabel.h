@@ -18,6 +18,7 @@
 #pragma once
 
 #include <QLabel>
+#include <QStaticText>
 
 class ElidingLabel : public QLabel {
   Q_OBJECT
@@ -27,5 +28,13 @@ public:
 
 protected:
     void paintEvent(QPaintEvent *event) override;
+
+private:
+    // The elided text laid out for the last text, width and font painted,
+    // the meters next to the label make it repaint all the time
+    QStaticText m_elided;
+    QString m_elidedText;
+    QFont m_elidedFont;
+    int m_elidedWidth = -1;
 };
 
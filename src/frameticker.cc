@@ -0,0 +1,85 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "frameticker.h"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+FrameTicker *FrameTicker::instance()
+{
+    // Parented to the application so it goes away together with it
+    static FrameTicker *ticker = new FrameTicker(qApp);
+    return ticker;
+}
+
+FrameTicker::FrameTicker(QObject *parent) :
+    QObject(parent)
+{
+    qreal refreshRate = 60.;
+    if (QGuiApplication::primaryScreen()) {
+        refreshRate = QGuiApplication::primaryScreen()->refreshRate();
+    }
+
+    // Some platforms report garbage (or 0) here
+    refreshRate = qBound(30., refreshRate, 144.);
+
+    m_timer.setTimerType(Qt::PreciseTimer);
+    m_timer.setInterval(qRound(1000. / refreshRate));
+    connect(&m_timer, &QTimer::timeout, this, &FrameTicker::onTick);
+
+    m_clock.start();
+}
+
+void FrameTicker::schedule(Client *client)
+{
+    m_clients.insert(client);
+
+    if (!m_timer.isActive()) {
+        m_timer.start();
+    }
+}
+
+void FrameTicker::unschedule(Client *client)
+{
+    m_clients.remove(client);
+
+    if (m_clients.isEmpty()) {
+        m_timer.stop();
+    }
+}
+
+void FrameTicker::onTick()
+{
+    const qint64 msecs = now();
+
+    // Clients may (un)schedule themselves or others while advancing
+    m_ticking.assign(m_clients.cbegin(), m_clients.cend());
+    for (Client *client : m_ticking) {
+        if (!m_clients.contains(client)) {
+            continue;
+        }
+
+        if (!client->advanceFrame(msecs)) {
+            m_clients.remove(client);
+        }
+    }
+
+    if (m_clients.isEmpty()) {
+        m_timer.stop();
+    }
+}
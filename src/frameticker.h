@@ -0,0 +1,61 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <QObject>
+#include <QTimer>
+#include <QElapsedTimer>
+#include <QSet>
+
+#include <vector>
+
+// One timer for everything that animates, so all meters advance in the same
+// frame instead of each running its own animation.
+class FrameTicker : public QObject
+{
+    Q_OBJECT
+
+public:
+    class Client
+    {
+    public:
+        virtual ~Client() = default;
+
+        // Return false when there is nothing left to animate
+        virtual bool advanceFrame(qint64 msecs) = 0;
+    };
+
+    static FrameTicker *instance();
+
+    void schedule(Client *client);
+    void unschedule(Client *client);
+
+    qint64 now() const { return m_clock.elapsed(); }
+
+private:
+    explicit FrameTicker(QObject *parent);
+
+    void onTick();
+
+    QTimer m_timer;
+    QElapsedTimer m_clock;
+    QSet<Client *> m_clients;
+
+    // The clients of the frame being advanced, reused so no frame allocates
+    std::vector<Client *> m_ticking;
+};
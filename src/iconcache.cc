@@ -0,0 +1,126 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "iconcache.h"
+
+#include <QApplication>
+#include <QLabel>
+#include <QPainter>
+
+static const char *const ICON_NAME_PROPERTY = "_pavucontrol_iconName";
+static const char *const ICON_FALLBACK_PROPERTY = "_pavucontrol_iconFallback";
+static const char *const ICON_SIZE_PROPERTY = "_pavucontrol_iconSize";
+static const char *const ICON_KEY_PROPERTY = "_pavucontrol_iconKey";
+
+static QString pixmapKey(const QString &name, const QString &fallback, int size, qreal devicePixelRatio)
+{
+    return name + QLatin1Char('\n') + fallback + QLatin1Char('\n')
+        + QString::number(size) + QLatin1Char('@') + QString::number(devicePixelRatio);
+}
+
+IconCache *IconCache::instance()
+{
+    // Parented to the application so it goes away together with it
+    static IconCache *cache = new IconCache(qApp);
+    return cache;
+}
+
+IconCache::IconCache(QObject *parent) :
+    QObject(parent)
+{
+}
+
+QIcon IconCache::themeIcon(const QString &name)
+{
+    auto it = m_icons.constFind(name);
+    if (it == m_icons.constEnd()) {
+        // Misses are cached as well, they are the expensive ones
+        it = m_icons.insert(name, QIcon::fromTheme(name));
+    }
+    return it.value();
+}
+
+bool IconCache::hasThemeIcon(const QString &name)
+{
+    return !name.isEmpty() && !themeIcon(name).isNull();
+}
+
+QIcon IconCache::icon(const QString &name, const QString &fallback)
+{
+    if (hasThemeIcon(name)) {
+        return themeIcon(name);
+    }
+
+    return themeIcon(fallback);
+}
+
+QPixmap IconCache::pixmap(const QString &name, const QString &fallback, int size, qreal devicePixelRatio)
+{
+    const QString key = pixmapKey(name, fallback, size, devicePixelRatio);
+
+    auto it = m_pixmaps.constFind(key);
+    if (it == m_pixmaps.constEnd()) {
+        // QIcon::pixmap() would scale for the application's ratio, not the
+        // screen's, so paint at the requested one instead
+        QPixmap pixmap(QSize(size, size) * devicePixelRatio);
+        pixmap.fill(Qt::transparent);
+        {
+            QPainter painter(&pixmap);
+            icon(name, fallback).paint(&painter, pixmap.rect());
+        }
+        pixmap.setDevicePixelRatio(devicePixelRatio);
+
+        it = m_pixmaps.insert(key, pixmap);
+    }
+    return it.value();
+}
+
+void IconCache::setPixmap(QLabel *label, const QString &name, const QString &fallback, int size)
+{
+    const qreal devicePixelRatio = label->devicePixelRatioF();
+    const QString key = pixmapKey(name, fallback, size, devicePixelRatio)
+        + QLatin1Char('#') + QString::number(m_generation);
+
+    if (label->property(ICON_KEY_PROPERTY).toString() == key) {
+        return;
+    }
+
+    label->setPixmap(pixmap(name, fallback, size, devicePixelRatio));
+    label->setProperty(ICON_NAME_PROPERTY, name);
+    label->setProperty(ICON_FALLBACK_PROPERTY, fallback);
+    label->setProperty(ICON_SIZE_PROPERTY, size);
+    label->setProperty(ICON_KEY_PROPERTY, key);
+}
+
+void IconCache::invalidate(QWidget *root)
+{
+    m_icons.clear();
+    m_pixmaps.clear();
+    m_generation++;
+
+    const QList<QLabel *> labels = root->findChildren<QLabel *>();
+    for (QLabel *label : labels) {
+        if (!label->property(ICON_KEY_PROPERTY).isValid()) {
+            continue;
+        }
+        setPixmap(label,
+            label->property(ICON_NAME_PROPERTY).toString(),
+            label->property(ICON_FALLBACK_PROPERTY).toString(),
+            label->property(ICON_SIZE_PROPERTY).toInt());
+    }
+}
@@ -0,0 +1,60 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QObject>
+#include <QHash>
+#include <QIcon>
+#include <QPixmap>
+
+class QLabel;
+class QWidget;
+
+// Theme lookups are surprisingly expensive (they stat their way through every
+// icon theme directory), and every stream and device widget used to do its
+// own on each update. This keeps the resolved icons and the rendered pixmaps
+// around for all of them until the theme changes.
+class IconCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    static IconCache *instance();
+
+    bool hasThemeIcon(const QString &name);
+    QIcon icon(const QString &name, const QString &fallback);
+    QPixmap pixmap(const QString &name, const QString &fallback, int size, qreal devicePixelRatio);
+
+    // Only calls QLabel::setPixmap() when the label would end up showing
+    // something different from what it already has
+    void setPixmap(QLabel *label, const QString &name, const QString &fallback, int size);
+
+    // Forgets everything resolved against the old theme and reloads the
+    // labels below root that got their pixmap from here
+    void invalidate(QWidget *root);
+
+private:
+    explicit IconCache(QObject *parent);
+
+    QIcon themeIcon(const QString &name);
+
+    QHash<QString, QIcon> m_icons;
+    QHash<QString, QPixmap> m_pixmaps;
+    quint32 m_generation = 0;
+};
@@ -19,6 +19,7 @@
 ***/
 
 #include "inputdevicewidget.h"
+#include "operationbatch.h"
 
 #include <QToolButton>
 #include <QComboBox>
@@ -32,11 +33,12 @@ void InputDeviceWidget::executeVolumeUpdate()
 {
     pa_operation *o;
 
-    if (!(o = pa_context_set_source_volume_by_index(get_context(), index, &volume, nullptr, nullptr))) {
+    if (!(o = pa_context_set_source_volume_by_index(get_context(), index, &volume, &VolumeWriter::callback, &volumeWriter))) {
         show_error(tr("pa_context_set_source_volume_by_index() failed").toUtf8().constData());
         return;
     }
 
+    volumeWriter.track(o);
     pa_operation_unref(o);
 }
 
@@ -48,13 +50,21 @@ void InputDeviceWidget::onMuteToggleButton()
         return;
     }
 
+    applyMute();
+}
+
+void InputDeviceWidget::executeMuteUpdate(bool mute, OperationBatch *batch)
+{
     pa_operation *o;
 
-    if (!(o = pa_context_set_source_mute_by_index(get_context(), index, muteToggleButton->isChecked(), nullptr, nullptr))) {
+    if (!(o = pa_context_set_source_mute_by_index(get_context(), index, mute, batch ? &OperationBatch::callback : nullptr, batch))) {
         show_error(tr("pa_context_set_source_mute_by_index() failed").toUtf8().constData());
         return;
     }
 
+    if (batch) {
+        batch->add(o);
+    }
     pa_operation_unref(o);
 }
 
@@ -72,6 +82,8 @@ void InputDeviceWidget::onDefaultToggleButton()
     }
 
     pa_operation_unref(o);
+
+    Q_EMIT defaultEdited();
 }
 
 void InputDeviceWidget::onPortChange()
@@ -92,5 +104,7 @@ void InputDeviceWidget::onPortChange()
         }
 
         pa_operation_unref(o);
+
+        Q_EMIT portEdited(activePort, port);
     }
 }
@@ -33,9 +33,12 @@ public:
 
     InputDeviceType type;
     bool can_decibel;
+    // Source output volumes are reported absolute, the source volume included
+    bool flatVolume = false;
 
     virtual void onMuteToggleButton();
     virtual void executeVolumeUpdate();
+    virtual void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr);
     virtual void onDefaultToggleButton();
 
 protected:
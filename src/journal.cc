@@ -0,0 +1,145 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "journal.h"
+
+// Older steps are dropped beyond this
+static const int maxSteps = 100;
+
+// Volume steps further apart than this are separate drags
+static const qint64 mergeInterval = 1000;
+
+Journal::Change Journal::change(Change::Kind kind, int tab, const QByteArray &object, const QByteArray &before, const QByteArray &after,
+                                uint32_t index)
+{
+    Change change;
+    change.kind = kind;
+    change.tab = tab;
+    change.object = object;
+    change.index = index;
+    change.before = before;
+    change.after = after;
+    pa_cvolume_init(&change.volumeBefore);
+    pa_cvolume_init(&change.volumeAfter);
+    return change;
+}
+
+Journal::Change Journal::volumeChange(int tab, const QByteArray &object, const pa_cvolume &before, const pa_cvolume &after,
+                                      uint32_t index)
+{
+    Change change = Journal::change(Change::Volume, tab, object, QByteArray(), QByteArray(), index);
+    change.volumeBefore = before;
+    change.volumeAfter = after;
+    return change;
+}
+
+bool Journal::canMerge(const Step &step) const
+{
+    if (!m_mergeable || m_undo.isEmpty() || m_lastRecord.elapsed() > mergeInterval) {
+        return false;
+    }
+
+    const Step &last = m_undo.last();
+    if (last.size() != step.size()) {
+        return false;
+    }
+
+    for (int i = 0; i < step.size(); i++) {
+        if (step[i].kind != Change::Volume || last[i].kind != Change::Volume) {
+            return false;
+        }
+
+        if (step[i].tab != last[i].tab || step[i].object != last[i].object || step[i].index != last[i].index) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+// Streams without a key couldn't be told apart later, and changes that
+// didn't change anything would only make undo look like it did nothing
+static bool isWorthKeeping(const Journal::Change &change)
+{
+    if (change.object.isEmpty() && change.kind != Journal::Change::Default) {
+        return false;
+    }
+
+    if (change.kind == Journal::Change::Volume) {
+        return !pa_cvolume_equal(&change.volumeBefore, &change.volumeAfter);
+    }
+
+    return change.before != change.after;
+}
+
+void Journal::record(const Step &changes)
+{
+    Step step;
+    for (const Change &change : changes) {
+        if (isWorthKeeping(change)) {
+            step.append(change);
+        }
+    }
+
+    if (step.isEmpty()) {
+        return;
+    }
+
+    m_redo.clear();
+
+    if (canMerge(step)) {
+        Step &last = m_undo.last();
+        for (int i = 0; i < step.size(); i++) {
+            last[i].volumeAfter = step[i].volumeAfter;
+        }
+    } else {
+        m_undo.append(step);
+        if (m_undo.size() > maxSteps) {
+            m_undo.removeFirst();
+        }
+    }
+
+    m_mergeable = true;
+    m_lastRecord.start();
+}
+
+Journal::Step Journal::undo()
+{
+    if (m_undo.isEmpty()) {
+        return Step();
+    }
+
+    m_mergeable = false;
+
+    const Step step = m_undo.takeLast();
+    m_redo.append(step);
+    return step;
+}
+
+Journal::Step Journal::redo()
+{
+    if (m_redo.isEmpty()) {
+        return Step();
+    }
+
+    m_mergeable = false;
+
+    const Step step = m_redo.takeLast();
+    m_undo.append(step);
+    return step;
+}
@@ -0,0 +1,82 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QVector>
+
+#include <pulse/def.h>
+#include <pulse/volume.h>
+
+// What the user changed, for undo and redo. Objects are kept by the server's
+// name (streams by their stream-restore id or application name), indices
+// may well have changed by the time a change is undone. Streams also keep
+// their index, several of them may share a name.
+class Journal
+{
+public:
+    struct Change
+    {
+        enum Kind {
+            Volume,
+            Mute,
+            Port,
+            Profile,
+            Default,
+            Move
+        };
+
+        Kind kind;
+        int tab;            // MainWindow::DeviceTab of the object
+        QByteArray object;  // device, card or stream, empty for defaults
+        uint32_t index;     // of the stream, preferred over object while it exists
+        QByteArray before;  // port, profile, mute ("0"/"1") or device name
+        QByteArray after;
+        pa_cvolume volumeBefore;
+        pa_cvolume volumeAfter;
+    };
+
+    // Undone and redone as a whole, like a change to a whole selection
+    typedef QVector<Change> Step;
+
+    static Change change(Change::Kind kind, int tab, const QByteArray &object, const QByteArray &before, const QByteArray &after,
+                         uint32_t index = PA_INVALID_INDEX);
+    static Change volumeChange(int tab, const QByteArray &object, const pa_cvolume &before, const pa_cvolume &after,
+                               uint32_t index = PA_INVALID_INDEX);
+
+    // Volume steps on the same objects in quick succession, i.e. one slider
+    // drag, end up as a single step
+    void record(const Step &step);
+
+    bool canUndo() const { return !m_undo.isEmpty(); }
+    bool canRedo() const { return !m_redo.isEmpty(); }
+
+    // The step to revert or reapply, moved over to the other side
+    Step undo();
+    Step redo();
+
+private:
+    bool canMerge(const Step &step) const;
+
+    QVector<Step> m_undo;
+    QVector<Step> m_redo;
+    QElapsedTimer m_lastRecord;
+    bool m_mergeable = false;
+};
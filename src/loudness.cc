@@ -0,0 +1,259 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "loudness.h"
+#include "meterdsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+constexpr size_t MOMENTARY_BLOCKS = 4;     // 400ms
+constexpr size_t SHORT_TERM_BLOCKS = 30;   // 3s
+constexpr unsigned OVERSAMPLING = 4;
+constexpr size_t TRUE_PEAK_TAPS = 48;
+
+// Keeps the scratch buffers small no matter how much arrives at once
+constexpr size_t MAX_CHUNK_FRAMES = 1024;
+
+static double toDecibel(double power)
+{
+    if (power <= 0.) {
+        return -std::numeric_limits<double>::infinity();
+    }
+
+    return 10. * std::log10(power);
+}
+
+void LoudnessAnalyzer::configure(unsigned rate, const std::vector<double> &weights)
+{
+    // K-weighting: high shelf modelling the head, then the RLB high pass.
+    // Derived for any rate, matches the coefficients in BS.1770 at 48kHz.
+    double f0 = 1681.974450955533;
+    const double gain = 3.999843853973347;
+    double q = 0.7071752369554196;
+
+    double k = std::tan(M_PI * f0 / rate);
+    const double vh = std::pow(10., gain / 20.);
+    const double vb = std::pow(vh, 0.4996667741545416);
+    double a0 = 1. + k / q + k * k;
+
+    m_filters[0].b0 = (vh + vb * k / q + k * k) / a0;
+    m_filters[0].b1 = 2. * (k * k - vh) / a0;
+    m_filters[0].b2 = (vh - vb * k / q + k * k) / a0;
+    m_filters[0].a1 = 2. * (k * k - 1.) / a0;
+    m_filters[0].a2 = (1. - k / q + k * k) / a0;
+
+    f0 = 38.13547087602444;
+    q = 0.5003270373238773;
+    k = std::tan(M_PI * f0 / rate);
+    a0 = 1. + k / q + k * k;
+
+    m_filters[1].b0 = 1.;
+    m_filters[1].b1 = -2.;
+    m_filters[1].b2 = 1.;
+    m_filters[1].a1 = 2. * (k * k - 1.) / a0;
+    m_filters[1].a2 = (1. - k / q + k * k) / a0;
+
+    // Windowed sinc with its cutoff at the original Nyquist frequency
+    m_tapsPerPhase = TRUE_PEAK_TAPS / OVERSAMPLING;
+    m_phases.assign(TRUE_PEAK_TAPS, 0.f);
+
+    const double center = (TRUE_PEAK_TAPS - 1) / 2.;
+    double sum = 0.;
+    std::vector<double> taps(TRUE_PEAK_TAPS);
+
+    for (size_t n = 0; n < TRUE_PEAK_TAPS; n++) {
+        const double x = (n - center) / OVERSAMPLING;
+        const double sinc = x == 0. ? 1. : std::sin(M_PI * x) / (M_PI * x);
+        const double window = 0.5 - 0.5 * std::cos(2. * M_PI * (n + 0.5) / TRUE_PEAK_TAPS);
+
+        taps[n] = sinc * window;
+        sum += taps[n];
+    }
+
+    for (size_t n = 0; n < TRUE_PEAK_TAPS; n++) {
+        const size_t phase = n % OVERSAMPLING;
+        const size_t tap = n / OVERSAMPLING;
+
+        m_phases[phase * m_tapsPerPhase + (m_tapsPerPhase - 1 - tap)] = float(taps[n] * OVERSAMPLING / sum);
+    }
+
+    m_channels.assign(weights.size(), ChannelState());
+
+    for (size_t c = 0; c < weights.size(); c++) {
+        m_channels[c].weight = weights[c];
+        m_channels[c].input.assign(m_tapsPerPhase - 1 + MAX_CHUNK_FRAMES, 0.f);
+        m_channels[c].filtered.assign(MAX_CHUNK_FRAMES, 0.f);
+    }
+
+    m_oversampled.assign(MAX_CHUNK_FRAMES, 0.f);
+
+    m_blockFrames = std::max(1u, rate / 10);
+    m_blockPosition = 0;
+    m_current = Block();
+
+    m_blocks.assign(SHORT_TERM_BLOCKS, Block());
+    m_blockCount = 0;
+}
+
+bool LoudnessAnalyzer::process(const float *samples, size_t frames)
+{
+    if (m_channels.empty()) {
+        return false;
+    }
+
+    const size_t completed = m_blockCount;
+    size_t offset = 0;
+
+    while (offset < frames) {
+        // Never let a chunk run over the end of a block
+        const size_t chunk = std::min({frames - offset, MAX_CHUNK_FRAMES, m_blockFrames - m_blockPosition});
+
+        processChunk(offset, chunk, samples);
+        offset += chunk;
+        m_blockPosition += chunk;
+
+        if (m_blockPosition == m_blockFrames) {
+            finishBlock();
+        }
+    }
+
+    return m_blockCount != completed;
+}
+
+void LoudnessAnalyzer::processChunk(size_t offset, size_t frames, const float *samples)
+{
+    const size_t channels = m_channels.size();
+    const size_t history = m_tapsPerPhase - 1;
+
+    for (size_t c = 0; c < channels; c++) {
+        ChannelState &channel = m_channels[c];
+        float *input = channel.input.data() + history;
+        float *filtered = channel.filtered.data();
+
+        // Deinterleave so everything below runs over contiguous memory
+        const float *source = samples + offset * channels + c;
+        for (size_t i = 0; i < frames; i++) {
+            input[i] = source[i * channels];
+        }
+
+        // The recursion can't be vectorized, but it's cheap
+        for (size_t i = 0; i < frames; i++) {
+            double value = input[i];
+
+            for (int stage = 0; stage < 2; stage++) {
+                const Biquad &f = m_filters[stage];
+                const double out = f.b0 * value + channel.s1[stage];
+                channel.s1[stage] = f.b1 * value - f.a1 * out + channel.s2[stage];
+                channel.s2[stage] = f.b2 * value - f.a2 * out;
+                value = out;
+            }
+
+            filtered[i] = float(value);
+        }
+
+        m_current.weightedEnergy += channel.weight * meterdsp::sumOfSquares(filtered, frames);
+        m_current.energy += meterdsp::sumOfSquares(input, frames);
+        m_current.truePeak = std::max(m_current.truePeak, truePeak(channel.input.data(), frames));
+
+        // Keep the tail around as history for the next chunk
+        std::copy(input + frames - history, input + frames, channel.input.data());
+    }
+}
+
+float LoudnessAnalyzer::truePeak(const float *input, size_t frames)
+{
+    // The original samples count as well
+    float peak = 0.f;
+    meterdsp::reducePeaks(input + m_tapsPerPhase - 1, frames, 1, &peak);
+
+    float *out = m_oversampled.data();
+
+    for (size_t phase = 0; phase < OVERSAMPLING; phase++) {
+        const float *taps = m_phases.data() + phase * m_tapsPerPhase;
+
+        // Accumulate tap by tap so the inner loop is a plain multiply-add
+        // over the whole chunk, which the compiler vectorizes
+        std::fill(out, out + frames, 0.f);
+        for (size_t tap = 0; tap < m_tapsPerPhase; tap++) {
+            const float coefficient = taps[tap];
+            const float *x = input + tap;
+
+            for (size_t i = 0; i < frames; i++) {
+                out[i] += coefficient * x[i];
+            }
+        }
+
+        float phasePeak;
+        meterdsp::reducePeaks(out, frames, 1, &phasePeak);
+        peak = std::max(peak, phasePeak);
+    }
+
+    return peak;
+}
+
+void LoudnessAnalyzer::finishBlock()
+{
+    m_blocks[m_blockCount % SHORT_TERM_BLOCKS] = m_current;
+    m_blockCount++;
+
+    m_current = Block();
+    m_blockPosition = 0;
+}
+
+LoudnessLevels LoudnessAnalyzer::levels() const
+{
+    const double silence = -std::numeric_limits<double>::infinity();
+    LoudnessLevels levels = { silence, silence, silence, silence };
+
+    if (m_channels.empty()) {
+        return levels;
+    }
+
+    const size_t available = std::min(m_blockCount, SHORT_TERM_BLOCKS);
+    const double blockSamples = double(m_blockFrames);
+
+    double weighted = 0., energy = 0.;
+    float peak = 0.f;
+
+    for (size_t i = 0; i < available; i++) {
+        const Block &block = m_blocks[(m_blockCount - 1 - i) % SHORT_TERM_BLOCKS];
+
+        weighted += block.weightedEnergy;
+        peak = std::max(peak, block.truePeak);
+
+        if (i < MOMENTARY_BLOCKS) {
+            energy += block.energy;
+        }
+
+        if (i + 1 == MOMENTARY_BLOCKS) {
+            levels.momentary = -0.691 + toDecibel(weighted / (MOMENTARY_BLOCKS * blockSamples));
+            levels.rms = toDecibel(energy / (MOMENTARY_BLOCKS * blockSamples * m_channels.size()));
+        }
+
+        if (i + 1 == SHORT_TERM_BLOCKS) {
+            levels.shortTerm = -0.691 + toDecibel(weighted / (SHORT_TERM_BLOCKS * blockSamples));
+        }
+    }
+
+    if (available > 0) {
+        levels.truePeak = 2. * toDecibel(peak);
+    }
+
+    return levels;
+}
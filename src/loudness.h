@@ -0,0 +1,93 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <cstddef>
+#include <vector>
+
+// All in dB, -infinity when silent or not measured yet
+struct LoudnessLevels
+{
+    double rms;         // dBFS over the momentary window
+    double truePeak;    // dBTP, highest over the short-term window
+    double momentary;   // LUFS, 400ms
+    double shortTerm;   // LUFS, 3s
+};
+
+// ITU-R BS.1770 loudness, K-weighted mean square in 100ms steps, plus RMS and
+// 4x oversampled true peak. Not thread safe, meant to live on one worker.
+class LoudnessAnalyzer
+{
+public:
+    // One weight per channel, 1.0 for front, 1.41 for surround, 0 for LFE
+    void configure(unsigned rate, const std::vector<double> &weights);
+
+    // Interleaved samples, returns true when a new 100ms block completed
+    bool process(const float *samples, size_t frames);
+
+    LoudnessLevels levels() const;
+
+    unsigned channels() const { return unsigned(m_channels.size()); }
+
+private:
+    struct Biquad
+    {
+        double b0, b1, b2, a1, a2;
+    };
+
+    struct ChannelState
+    {
+        double weight = 1.;
+
+        // Transposed direct form II state for both K-weighting stages
+        double s1[2] = {0., 0.};
+        double s2[2] = {0., 0.};
+
+        // Raw input with the true peak filter history in front
+        std::vector<float> input;
+        std::vector<float> filtered;
+    };
+
+    struct Block
+    {
+        double weightedEnergy = 0.;
+        double energy = 0.;
+        float truePeak = 0.f;
+    };
+
+    void processChunk(size_t offset, size_t frames, const float *samples);
+    void finishBlock();
+    float truePeak(const float *input, size_t frames);
+
+    Biquad m_filters[2] = {};
+    std::vector<ChannelState> m_channels;
+
+    // Polyphase interpolation filter, reversed so it can be applied as a
+    // sliding dot product over the input
+    std::vector<float> m_phases;
+    std::vector<float> m_oversampled;
+    size_t m_tapsPerPhase = 0;
+
+    size_t m_blockFrames = 0;
+    size_t m_blockPosition = 0;
+    Block m_current;
+
+    // Ring of the last 3 seconds of blocks
+    std::vector<Block> m_blocks;
+    size_t m_blockCount = 0;
+};
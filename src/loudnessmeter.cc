@@ -0,0 +1,77 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "loudnessmeter.h"
+
+#include <limits>
+
+static std::vector<double> channelWeights(const pa_channel_map &map)
+{
+    std::vector<double> weights(map.channels, 1.);
+
+    for (int i = 0; i < map.channels; i++) {
+        switch (map.map[i]) {
+        case PA_CHANNEL_POSITION_LFE:
+            weights[i] = 0.;
+            break;
+        case PA_CHANNEL_POSITION_REAR_LEFT:
+        case PA_CHANNEL_POSITION_REAR_RIGHT:
+        case PA_CHANNEL_POSITION_SIDE_LEFT:
+        case PA_CHANNEL_POSITION_SIDE_RIGHT:
+            weights[i] = 1.41;
+            break;
+        default:
+            break;
+        }
+    }
+
+    return weights;
+}
+
+LoudnessMeter::LoudnessMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent) :
+    MonitorTap(parent)
+{
+    const double silence = -std::numeric_limits<double>::infinity();
+    m_levels = { silence, silence, silence, silence };
+
+    start(tr("Loudness measurement"), source, stream, map);
+}
+
+LoudnessMeter::~LoudnessMeter()
+{
+    stop();
+}
+
+void LoudnessMeter::configure(const pa_sample_spec &spec, const pa_channel_map &map)
+{
+    m_analyzer.configure(spec.rate, channelWeights(map));
+}
+
+bool LoudnessMeter::analyze(const float *samples, size_t frames)
+{
+    return m_analyzer.process(samples, frames);
+}
+
+void LoudnessMeter::publish()
+{
+    const LoudnessLevels levels = m_analyzer.levels();
+
+    QMetaObject::invokeMethod(this, [this, levels] {
+        m_levels = levels;
+        Q_EMIT levelsChanged();
+    });
+}
@@ -0,0 +1,47 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "monitortap.h"
+#include "loudness.h"
+
+// Loudness of a source or sink input, see LoudnessAnalyzer
+class LoudnessMeter : public MonitorTap
+{
+    Q_OBJECT
+
+public:
+    LoudnessMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent = nullptr);
+    ~LoudnessMeter() override;
+
+    const LoudnessLevels &levels() const { return m_levels; }
+
+Q_SIGNALS:
+    void levelsChanged();
+
+protected:
+    void configure(const pa_sample_spec &spec, const pa_channel_map &map) override;
+    bool analyze(const float *samples, size_t frames) override;
+    void publish() override;
+
+private:
+    // Worker thread only
+    LoudnessAnalyzer m_analyzer;
+
+    LoudnessLevels m_levels;
+};
@@ -18,6 +18,7 @@
   along with pavucontrol. If not, see <https://www.gnu.org/licenses/>.
 ***/
 
+#include <algorithm>
 #include <set>
 
 #include "mainwindow.h"
@@ -28,10 +29,21 @@
 #include "recordingwidget.h"
 #include "rolewidget.h"
 #include "wavplay.h"
+#include "meterdsp.h"
+#include "loudnessmeter.h"
+#include "clipmeter.h"
+#include "spectrummeter.h"
+#include "streamlistmodel.h"
+#include "streamlistview.h"
+#include "iconcache.h"
+#include "volumefade.h"
+#include "operationbatch.h"
+#include "scene.h"
 #include "utils.h"
 
 #include <QIcon>
 #include <QStyle>
+#include <QEvent>
 #include <QSettings>
 #include <QScrollArea>
 #include <QDebug>
@@ -42,8 +54,26 @@
 #include <QComboBox>
 #include <QToolButton>
 #include <QMessageBox>
-
-QWidget *createTab(QWidget *contentList, QLabel *defaultLabel, QWidget *typeSelect)
+#include <QLineEdit>
+#include <QShortcut>
+#include <QSpinBox>
+#include <QMenu>
+#include <QInputDialog>
+#include <QLoggingCategory>
+
+// Off unless enabled with QT_LOGGING_RULES="pavucontrol-qt.widgetpool.debug=true"
+Q_LOGGING_CATEGORY(lcWidgetPool, "pavucontrol-qt.widgetpool", QtWarningMsg)
+// Likewise, "pavucontrol-qt.bulkload.debug=true" reports time to first paint
+Q_LOGGING_CATEGORY(lcBulkLoad, "pavucontrol-qt.bulkload", QtWarningMsg)
+
+// Defined in pavucontrol.cc, for re-reading the lists
+void sink_cb(pa_context *, const pa_sink_info *i, int eol, void *userdata);
+void source_cb(pa_context *, const pa_source_info *i, int eol, void *userdata);
+void card_cb(pa_context *, const pa_card_info *i, int eol, void *userdata);
+void sink_input_cb(pa_context *, const pa_sink_input_info *i, int eol, void *userdata);
+void source_output_cb(pa_context *, const pa_source_output_info *i, int eol, void *userdata);
+
+QWidget *createTab(QWidget *contentList, QLabel *defaultLabel, QWidget *typeSelect, QWidget *compactList = nullptr)
 {
     contentList->setLayout(new QVBoxLayout);
 
@@ -55,6 +85,11 @@ QWidget *createTab(QWidget *contentList, QLabel *defaultLabel, QWidget *typeSele
     scrollArea->setLayout(new QVBoxLayout);
     scrollArea->setWidgetResizable(true);
 
+    if (compactList) {
+        tabLayout->addWidget(compactList, 1);
+        compactList->hide();
+    }
+
     QHBoxLayout *typeLayout = new QHBoxLayout;
     typeLayout->addWidget(new QLabel(QObject::tr("Show:")));
     typeLayout->addWidget(typeSelect);
@@ -74,10 +109,12 @@ MainWindow::MainWindow(QWidget *parent):
     m_showOutputType(OUTPUT_ALL),
     m_showRecordingType(RECORDING_APPLICATION),
     m_showInputDeviceType(INPUT_DEVICE_NO_MONITOR),
+    m_meterMode(METER_COMBINED),
     m_eventRoleWidget(nullptr),
     m_canRenameDevices(false),
     m_connected(false),
-    m_config_filename(nullptr)
+    m_config_filename(nullptr),
+    m_playbackPool(16)
 {
     m_popPlayer = new WavPlay(":/data/bop.wav", this);
     connect(this, &MainWindow::pulseConnected, m_popPlayer, &WavPlay::uploadSample, Qt::QueuedConnection);
@@ -116,7 +153,65 @@ MainWindow::MainWindow(QWidget *parent):
     });
 
     m_showVolumeMetersCheckButton = new QCheckBox(tr("Show volume meters"));
+    m_meterModeComboBox = new QComboBox;
+    m_meterModeComboBox->addItems( {
+        tr("Combined Meter"),
+        tr("Per-Channel Meters"),
+        tr("Stereo Meters"),
+    });
 
+    m_showMeterHistoryCheckButton = new QCheckBox(tr("Show meter history"));
+    m_compactStreamListsCheckButton = new QCheckBox(tr("Compact stream lists"));
+    m_compactStreamListsCheckButton->setToolTip(tr("Show playback and recording streams as a plain list, for systems with many streams"));
+
+    m_muteFadeSpinBox = new QSpinBox;
+    m_muteFadeSpinBox->setPrefix(tr("Fade mutes: "));
+    m_muteFadeSpinBox->setSuffix(tr(" ms"));
+    m_muteFadeSpinBox->setSpecialValueText(tr("Mute instantly"));
+    m_muteFadeSpinBox->setRange(0, 5000);
+    m_muteFadeSpinBox->setSingleStep(50);
+    m_muteFadeSpinBox->setToolTip(tr("Ramp the volume down before muting and up after unmuting"));
+    m_rampSpinBox = new QSpinBox;
+    m_rampSpinBox->setPrefix(tr("Ramp restores: "));
+    m_rampSpinBox->setSuffix(tr(" ms"));
+    m_rampSpinBox->setSpecialValueText(tr("Restore instantly"));
+    m_rampSpinBox->setRange(0, 5000);
+    m_rampSpinBox->setSingleStep(50);
+    m_rampSpinBox->setToolTip(tr("Ramp volumes to their new level when undoing, redoing or switching scenes"));
+    m_fadeCurveComboBox = new QComboBox;
+    m_fadeCurveComboBox->addItem(tr("Linear Fades"), int(QEasingCurve::Linear));
+    m_fadeCurveComboBox->addItem(tr("Smooth Fades"), int(QEasingCurve::InOutSine));
+    m_fadeCurveComboBox->addItem(tr("Fast-Start Fades"), int(QEasingCurve::OutQuad));
+
+    m_scenesMenu = new QMenu(this);
+    m_scenesButton = new QToolButton;
+    m_scenesButton->setText(tr("Scenes"));
+    m_scenesButton->setToolTip(tr("Save the whole setup under a name, or switch back to a saved one"));
+    m_scenesButton->setPopupMode(QToolButton::InstantPopup);
+    m_scenesButton->setMenu(m_scenesMenu);
+
+    m_playbackList = new StreamListModel(StreamListModel::Playback, this);
+    m_playbackListView = new StreamListView;
+    m_playbackListView->setModel(m_playbackList);
+
+    m_recordingList = new StreamListModel(StreamListModel::Recording, this);
+    m_recordingListView = new StreamListView;
+    m_recordingListView->setModel(m_recordingList);
+
+    connectListEdits(m_playbackList, PLAYBACK_TAB);
+    connectListEdits(m_recordingList, RECORDING_TAB);
+
+    QWidget *meterOptions = new QWidget;
+    QHBoxLayout *meterOptionsLayout = new QHBoxLayout(meterOptions);
+    meterOptionsLayout->setMargin(0);
+    meterOptionsLayout->addWidget(m_showVolumeMetersCheckButton);
+    meterOptionsLayout->addWidget(m_meterModeComboBox);
+    meterOptionsLayout->addWidget(m_showMeterHistoryCheckButton);
+    meterOptionsLayout->addWidget(m_compactStreamListsCheckButton);
+    meterOptionsLayout->addWidget(m_muteFadeSpinBox);
+    meterOptionsLayout->addWidget(m_rampSpinBox);
+    meterOptionsLayout->addWidget(m_fadeCurveComboBox);
+    meterOptionsLayout->addWidget(m_scenesButton);
 
     m_connectingLabel = new QLabel;
     m_connectingLabel->setWordWrap(true);
@@ -137,12 +232,12 @@ MainWindow::MainWindow(QWidget *parent):
     // Do layout
     // Tabs
     m_notebook->addTab(
-            createTab(m_streamsVBox, m_noStreamsLabel, m_playbackTypeComboBox),
+            createTab(m_streamsVBox, m_noStreamsLabel, m_playbackTypeComboBox, m_playbackListView),
             QIcon::fromTheme("audio-radio-symbolic"), // idk, is at least distinguishable (spelling is hard)
             tr("&Playback")
             );
     m_notebook->addTab(
-            createTab(m_recsVBox, m_noRecsLabel, m_recordingTypeComboBox),
+            createTab(m_recsVBox, m_noRecsLabel, m_recordingTypeComboBox, m_recordingListView),
             QIcon::fromTheme("media-record-symbolic"),
             tr("&Recording")
             );
@@ -157,14 +252,37 @@ MainWindow::MainWindow(QWidget *parent):
             tr("&Input Devices")
             );
     m_notebook->addTab(
-            createTab(m_cardsVBox, m_noCardsLabel, m_showVolumeMetersCheckButton),
+            createTab(m_cardsVBox, m_noCardsLabel, meterOptions),
             QIcon::fromTheme("settings-configure"),
             tr("&Configuration")
             );
 
+    m_filterEdit = new QLineEdit;
+    m_filterEdit->setPlaceholderText(tr("Filter"));
+    m_filterEdit->setToolTip(tr("Show only what matches by application, stream or device name, or program"));
+    m_filterEdit->setClearButtonEnabled(true);
+    m_notebook->setCornerWidget(m_filterEdit, Qt::TopRightCorner);
+    connect(m_filterEdit, &QLineEdit::textChanged, this, &MainWindow::onFilterTextChanged);
+
+    QShortcut *filterShortcut = new QShortcut(QKeySequence::Find, this);
+    connect(filterShortcut, &QShortcut::activated, this, [this] {
+        m_filterEdit->setFocus(Qt::ShortcutFocusReason);
+        m_filterEdit->selectAll();
+    });
+
+    QShortcut *clearSelectionShortcut = new QShortcut(QKeySequence(Qt::Key_Escape), this);
+    connect(clearSelectionShortcut, &QShortcut::activated, this, &MainWindow::clearSelection);
+
     layout()->addWidget(m_notebook);
     layout()->addWidget(m_connectingLabel);
 
+    // The other tabs get their widgets and monitor streams once first shown.
+    // Queued so a tab picked on the command line is the one that gets built.
+    connect(m_notebook, &QTabWidget::currentChanged, this, &MainWindow::materializeTab);
+    QMetaObject::invokeMethod(this, [this] {
+        materializeTab(m_notebook->currentIndex());
+    }, Qt::QueuedConnection);
+
     m_playbackTypeComboBox->setCurrentIndex((int) m_showPlaybackType);
     m_recordingTypeComboBox->setCurrentIndex((int) m_showRecordingType);
     m_outputTypeComboBox->setCurrentIndex((int) m_showOutputType);
@@ -176,15 +294,57 @@ MainWindow::MainWindow(QWidget *parent):
     connect(m_outputTypeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::onOutputTypeComboBoxChanged);
     connect(m_inputDeviceTypeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::onInputDeviceTypeComboBoxChanged);
     connect(m_showVolumeMetersCheckButton, &QCheckBox::toggled, this, &MainWindow::onShowVolumeMetersCheckButtonToggled);
+    connect(m_showVolumeMetersCheckButton, &QCheckBox::toggled, m_meterModeComboBox, &QComboBox::setEnabled);
+    connect(m_meterModeComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::onMeterModeComboBoxChanged);
+    connect(m_showVolumeMetersCheckButton, &QCheckBox::toggled, m_showMeterHistoryCheckButton, &QCheckBox::setEnabled);
+    connect(m_showMeterHistoryCheckButton, &QCheckBox::toggled, this, &MainWindow::onShowMeterHistoryCheckButtonToggled);
+    connect(m_compactStreamListsCheckButton, &QCheckBox::toggled, this, &MainWindow::onCompactStreamListsCheckButtonToggled);
+    connect(m_muteFadeSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), &VolumeFade::setMuteDuration);
+    connect(m_rampSpinBox, static_cast<void(QSpinBox::*)(int)>(&QSpinBox::valueChanged), &VolumeFade::setRampDuration);
+    connect(m_fadeCurveComboBox, static_cast<void(QComboBox::*)(int)>(&QComboBox::currentIndexChanged), this, &MainWindow::onFadeCurveComboBoxChanged);
+    connect(m_scenesMenu, &QMenu::aboutToShow, this, &MainWindow::rebuildScenesMenu);
 
     QAction *quit = new QAction{this};
     connect(quit, &QAction::triggered, this, &QWidget::close);
     quit->setShortcut(QKeySequence::Quit);
     addAction(quit);
 
+    m_undoAction = new QAction{this};
+    connect(m_undoAction, &QAction::triggered, this, &MainWindow::undo);
+    m_undoAction->setShortcut(QKeySequence::Undo);
+    m_undoAction->setEnabled(false);
+    addAction(m_undoAction);
+
+    m_redoAction = new QAction{this};
+    connect(m_redoAction, &QAction::triggered, this, &MainWindow::redo);
+    m_redoAction->setShortcut(QKeySequence::Redo);
+    m_redoAction->setEnabled(false);
+    addAction(m_redoAction);
+
     const QSettings config;
 
     m_showVolumeMetersCheckButton->setChecked(config.value(QStringLiteral("window/showVolumeMeters"), true).toBool());
+    m_meterModeComboBox->setEnabled(m_showVolumeMetersCheckButton->isChecked());
+    m_showMeterHistoryCheckButton->setChecked(config.value(QStringLiteral("window/showMeterHistory"), false).toBool());
+    m_showMeterHistoryCheckButton->setEnabled(m_showVolumeMetersCheckButton->isChecked());
+    m_compactStreamListsCheckButton->setChecked(config.value(QStringLiteral("window/compactStreamLists"), false).toBool());
+    m_muteFadeSpinBox->setValue(config.value(QStringLiteral("window/muteFadeDuration"), 0).toInt());
+    VolumeFade::setMuteDuration(m_muteFadeSpinBox->value());
+    m_rampSpinBox->setValue(config.value(QStringLiteral("window/rampDuration"), 0).toInt());
+    VolumeFade::setRampDuration(m_rampSpinBox->value());
+
+    const QVariant fadeCurveSelection = config.value(QStringLiteral("window/fadeCurve"));
+
+    if (fadeCurveSelection.isValid()) {
+        m_fadeCurveComboBox->setCurrentIndex(fadeCurveSelection.toInt());
+    }
+    onFadeCurveComboBoxChanged(m_fadeCurveComboBox->currentIndex());
+
+    const QVariant meterModeSelection = config.value(QStringLiteral("window/meterMode"));
+
+    if (meterModeSelection.isValid()) {
+        m_meterModeComboBox->setCurrentIndex(meterModeSelection.toInt());
+    }
 
     const QVariant playbackTypeSelection = config.value(QStringLiteral("window/sinkInputType"));
 
@@ -218,6 +378,8 @@ MainWindow::MainWindow(QWidget *parent):
 
 MainWindow::~MainWindow()
 {
+    qCDebug(lcWidgetPool) << "Playback widget pool:" << m_playbackPool.hits() << "hits," << m_playbackPool.misses() << "misses";
+
     QSettings config;
     if (m_connected) {
         config.setValue(QStringLiteral("window/size"), size());
@@ -227,10 +389,299 @@ MainWindow::~MainWindow()
     config.setValue(QStringLiteral("window/sinkType"), m_outputTypeComboBox->currentIndex());
     config.setValue(QStringLiteral("window/sourceType"), m_inputDeviceTypeComboBox->currentIndex());
     config.setValue(QStringLiteral("window/showVolumeMeters"), m_showVolumeMetersCheckButton->isChecked());
+    config.setValue(QStringLiteral("window/meterMode"), m_meterModeComboBox->currentIndex());
+    config.setValue(QStringLiteral("window/showMeterHistory"), m_showMeterHistoryCheckButton->isChecked());
+    config.setValue(QStringLiteral("window/compactStreamLists"), m_compactStreamListsCheckButton->isChecked());
+    config.setValue(QStringLiteral("window/muteFadeDuration"), m_muteFadeSpinBox->value());
+    config.setValue(QStringLiteral("window/rampDuration"), m_rampSpinBox->value());
+    config.setValue(QStringLiteral("window/fadeCurve"), m_fadeCurveComboBox->currentIndex());
 
     m_clientNames.clear();
 }
 
+// Selected and not filtered away
+template<typename Widget>
+static QList<Widget *> selectedWidgets(const QHash<uint32_t, Widget *> &widgets)
+{
+    QList<Widget *> selected;
+
+    for (Widget *widget : widgets) {
+        if (widget->isSelected() && !widget->isHidden()) {
+            selected.append(widget);
+        }
+    }
+
+    return selected;
+}
+
+// What the journal knows a widget by, its index may be a new one by the
+// time a change is undone
+static QByteArray journalName(const DeviceWidget *widget)
+{
+    return widget->name.toUtf8();
+}
+
+static QByteArray journalName(const StreamWidget *widget)
+{
+    return widget->key;
+}
+
+// Devices have unique names, streams may share theirs with others
+static uint32_t journalIndex(const DeviceWidget *)
+{
+    return PA_INVALID_INDEX;
+}
+
+static uint32_t journalIndex(const StreamWidget *widget)
+{
+    return widget->index;
+}
+
+static uint32_t currentDevice(PlaybackWidget *widget)
+{
+    return widget->playbackIndex();
+}
+
+static uint32_t currentDevice(RecordingWidget *widget)
+{
+    return widget->sourceIndex();
+}
+
+static Journal::Change muteChange(int tab, const QByteArray &object, bool mute, uint32_t index)
+{
+    return Journal::change(Journal::Change::Mute, tab, object, mute ? "0" : "1", mute ? "1" : "0", index);
+}
+
+template<typename Widget, typename Device>
+static Journal::Change moveChange(Widget *widget, const QHash<uint32_t, Device *> &devices, uint32_t deviceIndex, int tab)
+{
+    const Device *from = devices.value(currentDevice(widget));
+    const Device *to = devices.value(deviceIndex);
+
+    return Journal::change(Journal::Change::Move, tab, journalName(widget),
+            from ? from->name.toUtf8() : QByteArray(), to ? to->name.toUtf8() : QByteArray(), journalIndex(widget));
+}
+
+// Volumes go out through each widget's own writer, the batch only waits
+// for them, so they get the same completion barrier as mutes and moves
+static void holdUntilWritten(VolumeWriter *writer, OperationBatch *batch)
+{
+    const OperationBatch::Hold hold = batch->hold();
+    writer->whenWritten([hold]() {});
+}
+
+// Likewise for a ramp, the batch waits for its last step to be written
+template<typename Widget>
+static void fadeInBatch(Widget *widget, const pa_cvolume &target, int msecs, OperationBatch *batch)
+{
+    const OperationBatch::Hold hold = batch->hold();
+    VolumeWriter *writer = &widget->volumeWriter;
+    widget->fadeTo(target, msecs, [writer, hold]() {
+        writer->whenWritten([hold]() {});
+    });
+}
+
+// The loudest channel of origin for all of them, each keeping its balance
+template<typename Widget>
+static void applySelectionVolume(const QHash<uint32_t, Widget *> &widgets, Widget *origin, OperationBatch *batch, int tab, Journal::Step *step)
+{
+    const pa_volume_t max = pa_cvolume_max(&origin->volume);
+
+    for (Widget *widget : selectedWidgets(widgets)) {
+        if (widget == origin) {
+            continue;
+        }
+
+        pa_cvolume volume = widget->volume;
+        pa_cvolume_scale(&volume, max);
+        step->append(Journal::volumeChange(tab, journalName(widget), widget->volume, volume, journalIndex(widget)));
+        // Follows the origin's slider as it is dragged, so no ramp
+        fadeInBatch(widget, volume, 0, batch);
+    }
+}
+
+template<typename Widget>
+static void applySelectionMute(const QHash<uint32_t, Widget *> &widgets, Widget *origin, OperationBatch *batch, int tab, Journal::Step *step)
+{
+    const bool mute = origin->muteToggleButton->isChecked();
+
+    for (Widget *widget : selectedWidgets(widgets)) {
+        if (widget != origin) {
+            if (widget->muteToggleButton->isChecked() == mute) {
+                continue;
+            }
+
+            widget->updating = true;
+            widget->muteToggleButton->setChecked(mute);
+            widget->updating = false;
+
+            step->append(muteChange(tab, journalName(widget), mute, journalIndex(widget)));
+        }
+
+        widget->applyMute(batch);
+    }
+}
+
+template<typename Widget, typename Device>
+static void moveSelection(const QHash<uint32_t, Widget *> &widgets, const QHash<uint32_t, Device *> &devices, uint32_t deviceIndex, OperationBatch *batch, int tab, Journal::Step *step)
+{
+    for (Widget *widget : selectedWidgets(widgets)) {
+        step->append(moveChange(widget, devices, deviceIndex, tab));
+        widget->moveTo(deviceIndex, batch);
+    }
+}
+
+// Undo and redo find the widgets again: the stream that was changed while
+// it is still there, else everything going by its name
+template<typename Widget>
+static QList<Widget *> journalTargets(const QHash<uint32_t, Widget *> &widgets, const QByteArray &name, uint32_t index)
+{
+    Widget *recorded = widgets.value(index);
+    if (recorded && journalName(recorded) == name) {
+        return { recorded };
+    }
+
+    QList<Widget *> targets;
+    for (Widget *widget : widgets) {
+        if (journalName(widget) == name) {
+            targets.append(widget);
+        }
+    }
+
+    return targets;
+}
+
+// Volumes ramp over the configured duration, also for scenes, which is why
+// it says if it found any
+template<typename Widget>
+static bool restoreVolume(const QHash<uint32_t, Widget *> &widgets, const QByteArray &name, uint32_t index, const pa_cvolume &volume, OperationBatch *batch)
+{
+    const QList<Widget *> targets = journalTargets(widgets, name, index);
+
+    for (Widget *widget : targets) {
+        // Recreated with another channel count, only the level carries over
+        pa_cvolume target = widget->volume;
+        if (target.channels == volume.channels) {
+            target = volume;
+        } else {
+            pa_cvolume_scale(&target, pa_cvolume_max(&volume));
+        }
+
+        fadeInBatch(widget, target, VolumeFade::rampDuration(), batch);
+    }
+
+    return !targets.isEmpty();
+}
+
+template<typename Widget>
+static void restoreMute(const QHash<uint32_t, Widget *> &widgets, const QByteArray &name, uint32_t index, bool mute, OperationBatch *batch)
+{
+    for (Widget *widget : journalTargets(widgets, name, index)) {
+        if (widget->muteToggleButton->isChecked() == mute) {
+            continue;
+        }
+
+        widget->updating = true;
+        widget->muteToggleButton->setChecked(mute);
+        widget->updating = false;
+
+        widget->applyMute(batch);
+    }
+}
+
+template<typename Widget, typename Device>
+static void restoreRoute(const QHash<uint32_t, Widget *> &widgets, const QHash<uint32_t, Device *> &devices, const QByteArray &name, uint32_t index, const QByteArray &deviceName, OperationBatch *batch)
+{
+    for (const Device *device : devices) {
+        if (device->name.toUtf8() != deviceName) {
+            continue;
+        }
+
+        for (Widget *widget : journalTargets(widgets, name, index)) {
+            if (currentDevice(widget) != device->index) {
+                widget->moveTo(device->index, batch);
+            }
+        }
+
+        return;
+    }
+}
+
+// The same for compact list rows, which jump to their volume, they have
+// nothing to ramp with
+static void restoreVolume(StreamListModel *list, const QByteArray &name, uint32_t index, const pa_cvolume &volume, OperationBatch *batch)
+{
+    for (uint32_t stream : list->findStreams(name, index)) {
+        list->setVolume(stream, volume);
+        holdUntilWritten(list->volumeWriter(stream), batch);
+    }
+}
+
+static void restoreMute(StreamListModel *list, const QByteArray &name, uint32_t index, bool mute, OperationBatch *batch)
+{
+    for (uint32_t stream : list->findStreams(name, index)) {
+        list->setMute(stream, mute, batch);
+    }
+}
+
+template<typename Device>
+static void restoreRoute(StreamListModel *list, const QHash<uint32_t, Device *> &devices, const QByteArray &name, uint32_t index, const QByteArray &deviceName, OperationBatch *batch)
+{
+    for (const Device *device : devices) {
+        if (device->name.toUtf8() != deviceName) {
+            continue;
+        }
+
+        for (uint32_t stream : list->findStreams(name, index)) {
+            list->moveTo(stream, device->index, batch);
+        }
+
+        return;
+    }
+}
+
+template<typename Widget>
+void MainWindow::connectEdits(Widget *widget, DeviceTab tab, const QHash<uint32_t, Widget *> &widgets)
+{
+    connect(widget, &MinimalStreamWidget::volumeEdited, this, [this, widget, tab, &widgets](const pa_cvolume &before) {
+        Journal::Step step;
+        step.append(Journal::volumeChange(tab, journalName(widget), before, widget->volume, journalIndex(widget)));
+
+        if (widget->isSelected()) {
+            OperationBatch *batch = startBatch({tab});
+            holdUntilWritten(&widget->volumeWriter, batch);
+            applySelectionVolume(widgets, widget, batch, tab, &step);
+            batch->seal();
+        }
+
+        recordStep(step);
+    });
+    connect(widget, &MinimalStreamWidget::muteEdited, this, [this, widget, tab, &widgets]() {
+        Journal::Step step;
+        step.append(muteChange(tab, journalName(widget), widget->muteToggleButton->isChecked(), journalIndex(widget)));
+
+        if (widget->isSelected()) {
+            OperationBatch *batch = startBatch({tab});
+            applySelectionMute(widgets, widget, batch, tab, &step);
+            batch->seal();
+        }
+
+        recordStep(step);
+    });
+}
+
+void MainWindow::connectListEdits(StreamListModel *list, DeviceTab tab)
+{
+    connect(list, &StreamListModel::volumeEdited, this, [this, list, tab](uint32_t index, const pa_cvolume &before) {
+        const StreamListModel::Stream &stream = list->stream(list->rowForIndex(index));
+        recordStep({Journal::volumeChange(tab, stream.key, before, stream.volume, index)});
+    });
+    connect(list, &StreamListModel::muteEdited, this, [this, list, tab](uint32_t index) {
+        const StreamListModel::Stream &stream = list->stream(list->rowForIndex(index));
+        recordStep({muteChange(tab, stream.key, stream.mute, index)});
+    });
+}
+
 class DeviceWidget;
 static void updatePorts(DeviceWidget *w, QHash<QByteArray, PortInfo> *ports)
 {
@@ -266,25 +717,81 @@ static void updatePorts(DeviceWidget *w, QHash<QByteArray, PortInfo> *ports)
 
 void MainWindow::setIconByName(QLabel *label, const QByteArray &name, const QByteArray &fallback)
 {
-    QIcon icon = QIcon::fromTheme(QString::fromUtf8(!name.isEmpty() ? name : fallback));
+    const int size = label->style()->pixelMetric(QStyle::PM_ToolBarIconSize);
+    IconCache::instance()->setPixmap(label, QString::fromUtf8(name), QString::fromUtf8(fallback), size);
+}
+
+// What the filter box looks at for a playback or recording stream
+static QStringList streamSearchFields(const char *name, const Properties &properties, const QByteArray &device)
+{
+    return {
+        QString::fromUtf8(name),
+        properties.applicationName,
+        properties.applicationProcessBinary,
+        QString::fromUtf8(device),
+    };
+}
 
-    if (icon.isNull()) {
-        qWarning() << "Unable to find icon" << name << "using fallback" << fallback;
+void MainWindow::updateCard(const pa_card_info &info)
+{
+    // The output and input device tabs need the ports too, so they are kept
+    // even while the Configuration tab isn't built
+    QHash<QByteArray, PortInfo> &cardPorts = m_cardPorts[info.index];
+    cardPorts.clear();
 
-        icon = QIcon::fromTheme(fallback);
+    for (uint32_t i = 0; i < info.n_ports; ++i) {
+        PortInfo p;
 
-        if (icon.isNull()) {
-            qWarning() << "Failed to load fallback icon" << fallback;
-            return;
+        p.name = info.ports[i]->name;
+        p.description = info.ports[i]->description;
+        p.priority = info.ports[i]->priority;
+        p.available = info.ports[i]->available;
+        p.direction = info.ports[i]->direction;
+        p.latency_offset = info.ports[i]->latency_offset;
+
+        for (uint32_t j = 0; j < info.ports[i]->n_profiles; j++) {
+            p.profiles.push_back(info.ports[i]->profiles2[j]->name);
         }
+
+        cardPorts[p.name] = p;
     }
 
-    const int size = label->style()->pixelMetric(QStyle::PM_ToolBarIconSize);
-    label->setPixmap(icon.pixmap(size, size));
-}
+    bool hasOutputs = false, hasSources = false;
+
+    QVector<pa_card_profile_info2 *> profiles;
+    for (uint32_t i=0; i<info.n_profiles; ++i) {
+        hasOutputs = hasOutputs || (info.profiles2[i]->n_sinks > 1);
+        hasSources = hasSources || (info.profiles2[i]->n_sources > 1);
+        profiles.append(info.profiles2[i]);
+    }
+
+    /* Because the port info for sinks and sources is discontinued we need
+     * to update the port info for them here. */
+    if (hasOutputs) {
+        for (OutputWidget *sw : m_outputWidgets) {
+            if (sw->card_index == info.index) {
+                sw->updating = true;
+                updatePorts(sw, &cardPorts);
+                sw->updating = false;
+            }
+        }
+    }
+
+    if (hasSources) {
+        for (InputDeviceWidget *sw : m_inputDeviceWidgets) {
+            if (sw->card_index == info.index) {
+                sw->updating = true;
+                updatePorts(sw, &cardPorts);
+                sw->updating = false;
+            }
+        }
+    }
+
+    if (!m_materializedTabs[CARD_TAB]) {
+        m_deferredIndices[CARD_TAB].insert(info.index);
+        return;
+    }
 
-void MainWindow::updateCard(const pa_card_info &info)
-{
     bool is_new = false;
 
     CardWidget *cardWidget = nullptr;
@@ -292,6 +799,9 @@ void MainWindow::updateCard(const pa_card_info &info)
         cardWidget = m_cardWidgets[info.index];
     } else {
         m_cardWidgets[info.index] = cardWidget = new CardWidget(this);
+        connect(cardWidget, &CardWidget::profileEdited, this, [this, cardWidget](const QByteArray &before, const QByteArray &after) {
+            recordStep({Journal::change(Journal::Change::Profile, CARD_TAB, cardWidget->cardName, before, after)});
+        });
         m_cardsVBox->layout()->addWidget(cardWidget);
         cardWidget->index = info.index;
         is_new = true;
@@ -300,43 +810,17 @@ void MainWindow::updateCard(const pa_card_info &info)
     cardWidget->updating = true;
 
     const QString name = QString::fromUtf8(info.name);
-    const QString description = utils::readProperty(info, PA_PROP_DEVICE_DESCRIPTION);
-    if (!description.isEmpty()) {
-        cardWidget->name = description;
+    cardWidget->cardName = info.name;
+    const Properties properties = Properties::decode(info.proplist);
+    if (!properties.deviceDescription.isEmpty()) {
+        cardWidget->name = properties.deviceDescription;
     } else {
         cardWidget->name = name;
     }
     cardWidget->nameLabel->setText(cardWidget->name);
+    updateSearchIndex(CARD_TAB, info.index, { cardWidget->name, name });
 
-    cardWidget->iconImage->setPixmap(utils::deviceIcon(info).pixmap(iconSize()));
-
-    cardWidget->hasOutputs = cardWidget->hasSources = false;
-
-    QVector<pa_card_profile_info2 *> profiles;
-    for (uint32_t i=0; i<info.n_profiles; ++i) {
-        cardWidget->hasOutputs = cardWidget->hasOutputs || (info.profiles2[i]->n_sinks > 1);
-        cardWidget->hasSources = cardWidget->hasSources || (info.profiles2[i]->n_sources > 1);
-        profiles.append(info.profiles2[i]);
-    }
-
-    cardWidget->ports.clear();
-
-    for (uint32_t i = 0; i < info.n_ports; ++i) {
-        PortInfo p;
-
-        p.name = info.ports[i]->name;
-        p.description = info.ports[i]->description;
-        p.priority = info.ports[i]->priority;
-        p.available = info.ports[i]->available;
-        p.direction = info.ports[i]->direction;
-        p.latency_offset = info.ports[i]->latency_offset;
-
-        for (uint32_t j = 0; j < info.ports[i]->n_profiles; j++) {
-            p.profiles.push_back(info.ports[i]->profiles2[j]->name);
-        }
-
-        cardWidget->ports[p.name] = p;
-    }
+    IconCache::instance()->setPixmap(cardWidget->iconImage, utils::deviceIconName(properties), QStringLiteral("audio-card"), iconSize());
 
     cardWidget->profiles.clear();
 
@@ -348,24 +832,12 @@ void MainWindow::updateCard(const pa_card_info &info)
         return lhs->priority > rhs->priority;
     });
 
+    const QSet<QByteArray> unplugged = CardWidget::unpluggedProfiles(info);
+
     for (pa_card_profile_info2 *p_profile : profiles) {
-        bool hasUnavailable = false, hasOther = false;
         QByteArray desc = p_profile->description;
 
-        for (const PortInfo &port : cardWidget->ports) {
-            if (std::find(port.profiles.begin(), port.profiles.end(), p_profile->name) == port.profiles.end()) {
-                continue;
-            }
-
-            if (port.available == PA_PORT_AVAILABLE_NO) {
-                hasUnavailable = true;
-            } else {
-                hasOther = true;
-                break;
-            }
-        }
-
-        if (hasUnavailable && !hasOther) {
+        if (unplugged.contains(QByteArray::fromRawData(p_profile->name, int(strlen(p_profile->name))))) {
             desc += tr(" (unplugged)").toUtf8().constData();
         }
 
@@ -382,32 +854,10 @@ void MainWindow::updateCard(const pa_card_info &info)
 
     cardWidget->activeProfile = info.active_profile ? info.active_profile->name : "";
 
-    /* Because the port info for sinks and sources is discontinued we need
-     * to update the port info for them here. */
-    if (cardWidget->hasOutputs) {
-        for (OutputWidget *sw : m_outputWidgets) {
-            if (sw->card_index == cardWidget->index) {
-                sw->updating = true;
-                updatePorts(sw, &cardWidget->ports);
-                sw->updating = false;
-            }
-        }
-    }
-
-    if (cardWidget->hasSources) {
-        for (InputDeviceWidget *sw : m_inputDeviceWidgets) {
-            if (sw->card_index == cardWidget->index) {
-                sw->updating = true;
-                updatePorts(sw, &cardWidget->ports);
-                sw->updating = false;
-            }
-        }
-    }
-
     cardWidget->prepareMenu();
 
     if (is_new) {
-        updateDeviceVisibility();
+        updateDeviceVisibility(CARD_TAB, info.index);
     }
 
     cardWidget->updating = false;
@@ -422,6 +872,22 @@ bool MainWindow::updateOutputWidget(const pa_sink_info &info)
     } else {
         m_outputWidgets[info.index] = outputWidget = new OutputWidget(this);
         connect(outputWidget, &OutputWidget::requestBop, this, &MainWindow::onPlaybackBopRequested, Qt::QueuedConnection);
+        connect(outputWidget, &MinimalStreamWidget::loudnessMeasurementToggled, this, [this, outputWidget](bool enabled) {
+            setLoudnessMeasurement(outputWidget, enabled);
+        });
+        connect(outputWidget, &MinimalStreamWidget::spectrumToggled, this, [this, outputWidget](bool enabled) {
+            setSpectrumAnalysis(outputWidget, enabled);
+        });
+        connect(outputWidget, &MinimalStreamWidget::clipDetectionToggled, this, [this, outputWidget](bool enabled) {
+            setClipDetection(outputWidget, enabled);
+        });
+        connectEdits(outputWidget, OUTPUT_TAB, m_outputWidgets);
+        connect(outputWidget, &DeviceWidget::portEdited, this, [this, outputWidget](const QByteArray &before, const QByteArray &after) {
+            recordStep({Journal::change(Journal::Change::Port, OUTPUT_TAB, outputWidget->name.toUtf8(), before, after)});
+        });
+        connect(outputWidget, &DeviceWidget::defaultEdited, this, [this, outputWidget]() {
+            recordStep({Journal::change(Journal::Change::Default, OUTPUT_TAB, QByteArray(), m_defaultSinkName, outputWidget->name.toUtf8())});
+        });
         outputWidget->setChannelMap(info.channel_map, !!(info.flags & PA_SINK_DECIBEL_VOLUME));
         m_outputsVBox->layout()->addWidget(outputWidget);
         outputWidget->index = info.index;
@@ -429,7 +895,9 @@ bool MainWindow::updateOutputWidget(const pa_sink_info &info)
         isNew = true;
 
         outputWidget->setBaseVolume(info.base_volume);
+        outputWidget->setChannelMetersEnabled(m_meterMode != METER_COMBINED);
         outputWidget->setVolumeMeterVisible(m_showVolumeMetersCheckButton->isChecked());
+        outputWidget->setMeterHistoryVisible(m_showMeterHistoryCheckButton->isChecked());
     }
 
     outputWidget->updating = true;
@@ -442,8 +910,9 @@ bool MainWindow::updateOutputWidget(const pa_sink_info &info)
     outputWidget->boldNameLabel->setText(QLatin1String(""));
     outputWidget->nameLabel->setText(QString::asprintf("%s", info.description).toHtmlEscaped());
     outputWidget->nameLabel->setToolTip(QString::fromUtf8(info.description));
+    updateSearchIndex(OUTPUT_TAB, info.index, { QString::fromUtf8(info.description), QString::fromUtf8(info.name) });
 
-    outputWidget->iconImage->setPixmap(utils::deviceIcon(info).pixmap(iconSize()));
+    IconCache::instance()->setPixmap(outputWidget->iconImage, utils::deviceIconName(Properties::decode(info.proplist)), QStringLiteral("audio-card"), iconSize());
 
     outputWidget->setVolume(info.volume);
     outputWidget->muteToggleButton->setChecked(info.mute);
@@ -475,9 +944,8 @@ bool MainWindow::updateOutputWidget(const pa_sink_info &info)
 
         outputWidget->activePort = info.active_port ? info.active_port->name : "";
 
-        CardWidget *cw = m_cardWidgets.value(info.card);
-        if (cw) {
-            updatePorts(outputWidget, &cw->ports);
+        if (m_cardPorts.contains(info.card)) {
+            updatePorts(outputWidget, &m_cardPorts[info.card]);
         }
     }
 
@@ -490,7 +958,12 @@ bool MainWindow::updateOutputWidget(const pa_sink_info &info)
     outputWidget->updating = false;
 
     if (isNew) {
-        updateDeviceVisibility();
+        updateDeviceVisibility(OUTPUT_TAB, info.index);
+
+        // Playback streams only offer to move when there is somewhere to go
+        if (m_outputWidgets.size() == 2) {
+            updateDeviceVisibility(PLAYBACK_TAB);
+        }
     }
 
     return isNew;
@@ -501,7 +974,8 @@ static void suspended_callback(pa_stream *s, void *userdata)
     MainWindow *w = static_cast<MainWindow *>(userdata);
 
     if (pa_stream_is_suspended(s)) {
-        w->updateVolumeMeter(pa_stream_get_device_index(s), PA_INVALID_INDEX, -1);
+        const float silence[PA_CHANNELS_MAX] = {};
+        w->updateVolumeMeter(pa_stream_get_device_index(s), PA_INVALID_INDEX, silence, *pa_stream_get_channel_map(s));
     }
 }
 
@@ -525,30 +999,48 @@ static void read_callback(pa_stream *stream, size_t length, void *userdata)
         return;
     }
 
+    const pa_channel_map *channelMap = pa_stream_get_channel_map(stream);
+    const size_t frameSize = channelMap->channels * sizeof(float);
+
     assert(length > 0);
-    assert(length % sizeof(float) == 0);
+    assert(length % frameSize == 0);
 
-    const double value = reinterpret_cast<const float *>(data)[length / sizeof(float) -1];
+    // Look at the whole fragment, not only the last frame in it
+    float peaks[PA_CHANNELS_MAX];
+    meterdsp::reducePeaks(reinterpret_cast<const float *>(data), length / frameSize, channelMap->channels, peaks);
 
     pa_stream_drop(stream);
 
-    mainWindow->updateVolumeMeter(pa_stream_get_device_index(stream), pa_stream_get_monitor_stream(stream), qBound(0., value, 1.));
+    // Not clamped, clipping is detected on these
+    mainWindow->updateVolumeMeter(pa_stream_get_device_index(stream), pa_stream_get_monitor_stream(stream), peaks, *channelMap);
 }
 
-pa_stream *MainWindow::createMonitorStreamForSource(uint32_t source_idx, uint32_t stream_idx = -1)
+static void destroyMonitorStream(pa_stream *stream)
 {
-    pa_sample_spec sampleSpec;
-    sampleSpec.channels = 1;
+    pa_stream_set_read_callback(stream, nullptr, nullptr);
+    pa_stream_set_suspended_callback(stream, nullptr, nullptr);
+    pa_stream_disconnect(stream);
+    pa_stream_unref(stream);
+}
+
+pa_stream *MainWindow::createMonitorStreamForSource(uint32_t source_idx, uint32_t stream_idx, const pa_channel_map &deviceMap)
+{
+    // Always every channel, a server side downmix averages a clip on one
+    // channel away. The meters fold them into the meter mode themselves.
+    const pa_channel_map channelMap = deviceMap;
+
+    pa_sample_spec sampleSpec;
+    sampleSpec.channels = channelMap.channels;
     sampleSpec.format = PA_SAMPLE_FLOAT32;
     sampleSpec.rate = 25;
 
     pa_buffer_attr attributes{};
-    attributes.fragsize = sizeof(float);
+    attributes.fragsize = sizeof(float) * channelMap.channels;
     attributes.maxlength = (uint32_t) -1;
 
     const QByteArray streamName = tr("Peak detect").toUtf8();
 
-    pa_stream *stream = pa_stream_new(get_context(), streamName.constData(), &sampleSpec, nullptr);
+    pa_stream *stream = pa_stream_new(get_context(), streamName.constData(), &sampleSpec, &channelMap);
     if (!stream) {
         QMessageBox::warning(this, tr("Error creating monitor"), tr("Failed to create monitoring stream"));
         return nullptr;
@@ -586,12 +1078,109 @@ void MainWindow::createMonitorStreamForPlayback(PlaybackWidget *playbackWidget,
     }
 
     if (playbackWidget->peak) {
-        pa_stream_disconnect(playbackWidget->peak);
+        destroyMonitorStream(playbackWidget->peak);
         playbackWidget->peak = nullptr;
     }
 
     playbackWidget->setVolumeMeterVisible(true);
-    playbackWidget->peak = createMonitorStreamForSource(m_outputWidgets[sink_idx]->monitor_index, playbackWidget->index);
+    playbackWidget->peak = createMonitorStreamForSource(m_outputWidgets[sink_idx]->monitor_index, playbackWidget->index, playbackWidget->channelMap);
+}
+
+// Where to tap a widget's audio from. Source outputs can't be monitored on
+// their own, so recordings measure the source they record from.
+bool MainWindow::monitorSourceFor(MinimalStreamWidget *widget, uint32_t *source_idx, uint32_t *stream_idx)
+{
+    *stream_idx = PA_INVALID_INDEX;
+
+    if (OutputWidget *outputWidget = qobject_cast<OutputWidget *>(widget)) {
+        *source_idx = outputWidget->monitor_index;
+    } else if (InputDeviceWidget *inputDeviceWidget = qobject_cast<InputDeviceWidget *>(widget)) {
+        *source_idx = inputDeviceWidget->index;
+    } else if (PlaybackWidget *playbackWidget = qobject_cast<PlaybackWidget *>(widget)) {
+        OutputWidget *outputWidget = m_outputWidgets.value(playbackWidget->playbackIndex());
+        if (!outputWidget) {
+            return false;
+        }
+
+        *source_idx = outputWidget->monitor_index;
+        *stream_idx = playbackWidget->index;
+    } else if (RecordingWidget *recordingWidget = qobject_cast<RecordingWidget *>(widget)) {
+        *source_idx = recordingWidget->sourceIndex();
+    } else {
+        return false;
+    }
+
+    return *source_idx != PA_INVALID_INDEX;
+}
+
+void MainWindow::setLoudnessMeasurement(MinimalStreamWidget *widget, bool enabled)
+{
+    // Always start over, the source might have changed
+    widget->setLoudnessMeter(nullptr);
+
+    if (!enabled) {
+        return;
+    }
+
+    uint32_t source_idx, stream_idx;
+    if (!monitorSourceFor(widget, &source_idx, &stream_idx)) {
+        qWarning() << "No source to measure loudness on";
+        return;
+    }
+
+    LoudnessMeter *meter = new LoudnessMeter(source_idx, stream_idx, widget->channelMap);
+    if (!meter->isValid()) {
+        delete meter;
+        return;
+    }
+
+    widget->setLoudnessMeter(meter);
+}
+
+void MainWindow::setSpectrumAnalysis(MinimalStreamWidget *widget, bool enabled)
+{
+    widget->setSpectrumMeter(nullptr);
+
+    if (!enabled) {
+        return;
+    }
+
+    uint32_t source_idx, stream_idx;
+    if (!monitorSourceFor(widget, &source_idx, &stream_idx)) {
+        qWarning() << "No source to analyze";
+        return;
+    }
+
+    SpectrumMeter *meter = new SpectrumMeter(source_idx, stream_idx, widget->channelMap);
+    if (!meter->isValid()) {
+        delete meter;
+        return;
+    }
+
+    widget->setSpectrumMeter(meter);
+}
+
+void MainWindow::setClipDetection(MinimalStreamWidget *widget, bool enabled)
+{
+    widget->setClipMeter(nullptr);
+
+    if (!enabled) {
+        return;
+    }
+
+    uint32_t source_idx, stream_idx;
+    if (!monitorSourceFor(widget, &source_idx, &stream_idx)) {
+        qWarning() << "No source to detect clipping on";
+        return;
+    }
+
+    ClipMeter *meter = new ClipMeter(source_idx, stream_idx, widget->channelMap);
+    if (!meter->isValid()) {
+        delete meter;
+        return;
+    }
+
+    widget->setClipMeter(meter);
 }
 
 void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
@@ -602,6 +1191,22 @@ void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
         inputDeviceWidget = m_inputDeviceWidgets[info.index];
     } else {
         m_inputDeviceWidgets[info.index] = inputDeviceWidget = new InputDeviceWidget(this);
+        connect(inputDeviceWidget, &MinimalStreamWidget::loudnessMeasurementToggled, this, [this, inputDeviceWidget](bool enabled) {
+            setLoudnessMeasurement(inputDeviceWidget, enabled);
+        });
+        connect(inputDeviceWidget, &MinimalStreamWidget::spectrumToggled, this, [this, inputDeviceWidget](bool enabled) {
+            setSpectrumAnalysis(inputDeviceWidget, enabled);
+        });
+        connect(inputDeviceWidget, &MinimalStreamWidget::clipDetectionToggled, this, [this, inputDeviceWidget](bool enabled) {
+            setClipDetection(inputDeviceWidget, enabled);
+        });
+        connectEdits(inputDeviceWidget, INPUT_DEVICE_TAB, m_inputDeviceWidgets);
+        connect(inputDeviceWidget, &DeviceWidget::portEdited, this, [this, inputDeviceWidget](const QByteArray &before, const QByteArray &after) {
+            recordStep({Journal::change(Journal::Change::Port, INPUT_DEVICE_TAB, inputDeviceWidget->name.toUtf8(), before, after)});
+        });
+        connect(inputDeviceWidget, &DeviceWidget::defaultEdited, this, [this, inputDeviceWidget]() {
+            recordStep({Journal::change(Journal::Change::Default, INPUT_DEVICE_TAB, QByteArray(), m_defaultSourceName, inputDeviceWidget->name.toUtf8())});
+        });
 
         inputDeviceWidget->setChannelMap(info.channel_map, !!(info.flags & PA_SOURCE_DECIBEL_VOLUME));
         m_inputDevicesVBox->layout()->addWidget(inputDeviceWidget);
@@ -610,11 +1215,18 @@ void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
         isNew = true;
 
         inputDeviceWidget->setBaseVolume(info.base_volume);
+        inputDeviceWidget->setChannelMetersEnabled(m_meterMode != METER_COMBINED);
         inputDeviceWidget->setVolumeMeterVisible(m_showVolumeMetersCheckButton->isChecked());
+        inputDeviceWidget->setMeterHistoryVisible(m_showMeterHistoryCheckButton->isChecked());
 
         if (pa_context_get_server_protocol_version(get_context()) >= 13) {
             inputDeviceWidget->setVolumeMeterVisible(true);
-            inputDeviceWidget->peak = createMonitorStreamForSource(info.index, -1);
+
+            // Only opened once something shows the meters, see materializeTab()
+            if (m_materializedTabs[INPUT_DEVICE_TAB] || m_materializedTabs[RECORDING_TAB]
+                    || (m_materializedTabs[OUTPUT_TAB] && info.monitor_of_sink != PA_INVALID_INDEX)) {
+                inputDeviceWidget->peak = createMonitorStreamForSource(info.index, -1, info.channel_map);
+            }
         }
     }
 
@@ -624,15 +1236,18 @@ void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
     inputDeviceWidget->name = info.name;
     inputDeviceWidget->description = info.description;
     inputDeviceWidget->type = info.monitor_of_sink != PA_INVALID_INDEX ? INPUT_DEVICE_MONITOR : (info.flags & PA_SOURCE_HARDWARE ? INPUT_DEVICE_HARDWARE : INPUT_DEVICE_VIRTUAL);
+    inputDeviceWidget->flatVolume = !!(info.flags & PA_SOURCE_FLAT_VOLUME);
 
     inputDeviceWidget->boldNameLabel->setText(QLatin1String(""));
     inputDeviceWidget->nameLabel->setText(QString::asprintf("%s", info.description).toHtmlEscaped());
     inputDeviceWidget->nameLabel->setToolTip(QString::fromUtf8(info.description));
+    updateSearchIndex(INPUT_DEVICE_TAB, info.index, { QString::fromUtf8(info.description), QString::fromUtf8(info.name) });
 
+    const Properties properties = Properties::decode(info.proplist);
     if (inputDeviceWidget->type == INPUT_DEVICE_MONITOR) {
-        inputDeviceWidget->iconImage->setPixmap(utils::deviceIcon(info).pixmap(iconSize()));
+        IconCache::instance()->setPixmap(inputDeviceWidget->iconImage, utils::deviceIconName(properties), QStringLiteral("audio-card"), iconSize());
     } else {
-        inputDeviceWidget->iconImage->setPixmap(utils::findIcon(info, "audio-input-microphone").pixmap(iconSize()));
+        IconCache::instance()->setPixmap(inputDeviceWidget->iconImage, utils::findIconName(properties, "audio-input-microphone"), QStringLiteral("audio-input-microphone"), iconSize());
     }
 
     inputDeviceWidget->setVolume(info.volume);
@@ -664,9 +1279,8 @@ void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
 
         inputDeviceWidget->activePort = info.active_port ? info.active_port->name : "";
 
-        CardWidget *cardWidget = m_cardWidgets.value(info.card);
-        if (cardWidget) {
-            updatePorts(inputDeviceWidget, &cardWidget->ports);
+        if (m_cardPorts.contains(info.card)) {
+            updatePorts(inputDeviceWidget, &m_cardPorts[info.card]);
         }
     }
 
@@ -675,20 +1289,58 @@ void MainWindow::updateInputDeviceWidget(const pa_source_info &info)
     inputDeviceWidget->updating = false;
 
     if (isNew) {
-        updateDeviceVisibility();
+        updateDeviceVisibility(INPUT_DEVICE_TAB, info.index);
+
+        if (m_inputDeviceWidgets.size() == 2) {
+            updateDeviceVisibility(RECORDING_TAB);
+        }
     }
 }
 
 void MainWindow::updatePlaybackWidget(const pa_sink_input_info &info)
 {
-    if (utils::shouldIgnoreApp(info)) { // Those handled by the generic event volume control
+    const Properties properties = Properties::decode(info.proplist);
+    if (utils::shouldIgnoreApp(properties)) { // Those handled by the generic event volume control
+        return;
+    }
+
+    if (m_compactStreamLists) {
+        StreamListModel::Stream stream;
+        stream.index = info.index;
+        stream.client = info.client;
+        stream.device = info.sink;
+        stream.type = info.client != PA_INVALID_INDEX ? SINK_INPUT_CLIENT : SINK_INPUT_VIRTUAL;
+        stream.key = utils::streamKey(properties);
+        stream.name = QString::fromUtf8(info.name);
+        stream.icon = IconCache::instance()->icon(utils::findIconName(properties, "audio-card"), QStringLiteral("audio-card"));
+        stream.volume = info.volume;
+        stream.mute = info.mute;
+
+        const OutputWidget *outputWidget = m_outputWidgets.value(info.sink);
+        if (outputWidget) {
+            stream.deviceName = QString::fromUtf8(outputWidget->description);
+        }
+
+        updateSearchIndex(PLAYBACK_TAB, info.index, streamSearchFields(info.name, properties, outputWidget ? outputWidget->description : QByteArray()));
+
+        if (m_playbackList->updateStream(stream)) {
+            updateDeviceVisibility(PLAYBACK_TAB, info.index);
+        }
+
+        return;
+    }
+
+    if (!m_materializedTabs[PLAYBACK_TAB]) {
+        m_deferredIndices[PLAYBACK_TAB].insert(info.index);
         return;
     }
 
     bool is_new = false;
+    bool moved = false;
     PlaybackWidget *playbackWidget;
     if (m_playbackWidgets.count(info.index)) {
         playbackWidget = m_playbackWidgets[info.index];
+        moved = playbackWidget->playbackIndex() != info.sink;
 
         if (pa_context_get_server_protocol_version(get_context()) >= 13) {
             if (playbackWidget->playbackIndex() != info.sink) {
@@ -696,15 +1348,46 @@ void MainWindow::updatePlaybackWidget(const pa_sink_input_info &info)
             }
         }
     } else {
-        m_playbackWidgets[info.index] = playbackWidget = new PlaybackWidget(this);
-        connect(playbackWidget, &PlaybackWidget::requestBop, this, &MainWindow::onPlaybackBopRequested, Qt::QueuedConnection);
+        playbackWidget = m_playbackPool.take(info.channel_map.channels);
+
+        if (!playbackWidget) {
+            playbackWidget = new PlaybackWidget(this);
+            connect(playbackWidget, &PlaybackWidget::requestBop, this, &MainWindow::onPlaybackBopRequested, Qt::QueuedConnection);
+            connect(playbackWidget, &MinimalStreamWidget::loudnessMeasurementToggled, this, [this, playbackWidget](bool enabled) {
+                setLoudnessMeasurement(playbackWidget, enabled);
+            });
+            connect(playbackWidget, &MinimalStreamWidget::spectrumToggled, this, [this, playbackWidget](bool enabled) {
+                setSpectrumAnalysis(playbackWidget, enabled);
+            });
+            connect(playbackWidget, &MinimalStreamWidget::clipDetectionToggled, this, [this, playbackWidget](bool enabled) {
+                setClipDetection(playbackWidget, enabled);
+            });
+            connectEdits(playbackWidget, PLAYBACK_TAB, m_playbackWidgets);
+            connect(playbackWidget, &StreamWidget::moveEdited, this, [this, playbackWidget](uint32_t sinkIndex) {
+                Journal::Step step;
+
+                if (playbackWidget->isSelected()) {
+                    OperationBatch *batch = startBatch({PLAYBACK_TAB});
+                    moveSelection(m_playbackWidgets, m_outputWidgets, sinkIndex, batch, PLAYBACK_TAB, &step);
+                    batch->seal();
+                } else {
+                    step.append(moveChange(playbackWidget, m_outputWidgets, sinkIndex, PLAYBACK_TAB));
+                }
+
+                recordStep(step);
+            });
+        }
+
+        m_playbackWidgets[info.index] = playbackWidget;
         playbackWidget->setChannelMap(info.channel_map, true);
         m_streamsVBox->layout()->addWidget(playbackWidget);
 
         playbackWidget->index = info.index;
         playbackWidget->clientIndex = info.client;
         is_new = true;
+        playbackWidget->setChannelMetersEnabled(m_meterMode != METER_COMBINED);
         playbackWidget->setVolumeMeterVisible(m_showVolumeMetersCheckButton->isChecked());
+        playbackWidget->setMeterHistoryVisible(m_showMeterHistoryCheckButton->isChecked());
 
         if (pa_context_get_server_protocol_version(get_context()) >= 13) {
             createMonitorStreamForPlayback(playbackWidget, info.sink);
@@ -714,9 +1397,22 @@ void MainWindow::updatePlaybackWidget(const pa_sink_input_info &info)
     playbackWidget->updating = true;
 
     playbackWidget->type = info.client != PA_INVALID_INDEX ? SINK_INPUT_CLIENT : SINK_INPUT_VIRTUAL;
+    playbackWidget->key = utils::streamKey(properties);
 
     playbackWidget->setPlaybackIndex(info.sink);
 
+    if (moved && playbackWidget->loudnessMeter()) {
+        setLoudnessMeasurement(playbackWidget, true);
+    }
+
+    if (moved && playbackWidget->spectrumMeter()) {
+        setSpectrumAnalysis(playbackWidget, true);
+    }
+
+    if (moved && playbackWidget->clipMeter()) {
+        setClipDetection(playbackWidget, true);
+    }
+
     if (m_clientNames.contains(info.client)) {
         playbackWidget->boldNameLabel->setText(QStringLiteral("<b>%1</b>").arg(m_clientNames[info.client]));
         playbackWidget->nameLabel->setText(QString::asprintf(": %s", info.name).toHtmlEscaped());
@@ -727,45 +1423,113 @@ void MainWindow::updatePlaybackWidget(const pa_sink_input_info &info)
 
     playbackWidget->nameLabel->setToolTip(QString::fromUtf8(info.name));
 
-    playbackWidget->iconImage->setPixmap(utils::findIcon(info, "audio-card").pixmap(iconSize()));
+    IconCache::instance()->setPixmap(playbackWidget->iconImage, utils::findIconName(properties, "audio-card"), QStringLiteral("audio-card"), iconSize());
 
     playbackWidget->setVolume(info.volume);
     playbackWidget->muteToggleButton->setChecked(info.mute);
 
     playbackWidget->updating = false;
 
+    const OutputWidget *outputWidget = m_outputWidgets.value(info.sink);
+    updateSearchIndex(PLAYBACK_TAB, info.index, streamSearchFields(info.name, properties, outputWidget ? outputWidget->description : QByteArray()));
+
     if (is_new) {
-        updateDeviceVisibility();
+        updateDeviceVisibility(PLAYBACK_TAB, info.index);
     }
 }
 
 void MainWindow::updateRecordingWidget(const pa_source_output_info &info)
 {
-    if (utils::shouldIgnoreApp(info)) { // Those handled by the generic event volume control
+    const Properties properties = Properties::decode(info.proplist);
+    if (utils::shouldIgnoreApp(properties)) { // Those handled by the generic event volume control
+        return;
+    }
+
+    if (m_compactStreamLists) {
+        StreamListModel::Stream stream;
+        stream.index = info.index;
+        stream.client = info.client;
+        stream.device = info.source;
+        stream.type = info.client != PA_INVALID_INDEX ? RECORDING_APPLICATION : RECORDING_VIRTUAL;
+        stream.key = utils::streamKey(properties);
+        stream.name = QString::fromUtf8(info.name);
+        stream.icon = IconCache::instance()->icon(utils::findIconName(properties, "audio-input-microphone"), QStringLiteral("audio-input-microphone"));
+        stream.volume = info.volume;
+        stream.mute = info.mute;
+
+        const InputDeviceWidget *inputDeviceWidget = m_inputDeviceWidgets.value(info.source);
+        if (inputDeviceWidget) {
+            stream.deviceName = QString::fromUtf8(inputDeviceWidget->description);
+        }
+
+        updateSearchIndex(RECORDING_TAB, info.index, streamSearchFields(info.name, properties, inputDeviceWidget ? inputDeviceWidget->description : QByteArray()));
+
+        if (m_recordingList->updateStream(stream)) {
+            updateDeviceVisibility(RECORDING_TAB, info.index);
+        }
+
+        return;
+    }
+
+    if (!m_materializedTabs[RECORDING_TAB]) {
+        m_deferredIndices[RECORDING_TAB].insert(info.index);
         return;
     }
 
     bool isNew = false;
+    bool moved = false;
     RecordingWidget *recordingWidget;
     if (m_recordingWidgets.count(info.index)) {
         recordingWidget = m_recordingWidgets[info.index];
+        moved = recordingWidget->sourceIndex() != info.source;
     } else {
         m_recordingWidgets[info.index] = recordingWidget = new RecordingWidget(this);
+        connect(recordingWidget, &MinimalStreamWidget::loudnessMeasurementToggled, this, [this, recordingWidget](bool enabled) {
+            setLoudnessMeasurement(recordingWidget, enabled);
+        });
+        connect(recordingWidget, &MinimalStreamWidget::clipDetectionToggled, this, [this, recordingWidget](bool enabled) {
+            setClipDetection(recordingWidget, enabled);
+        });
+        connectEdits(recordingWidget, RECORDING_TAB, m_recordingWidgets);
+        connect(recordingWidget, &StreamWidget::moveEdited, this, [this, recordingWidget](uint32_t sourceIndex) {
+            Journal::Step step;
+
+            if (recordingWidget->isSelected()) {
+                OperationBatch *batch = startBatch({RECORDING_TAB});
+                moveSelection(m_recordingWidgets, m_inputDeviceWidgets, sourceIndex, batch, RECORDING_TAB, &step);
+                batch->seal();
+            } else {
+                step.append(moveChange(recordingWidget, m_inputDeviceWidgets, sourceIndex, RECORDING_TAB));
+            }
+
+            recordStep(step);
+        });
         recordingWidget->setChannelMap(info.channel_map, true);
         m_recsVBox->layout()->addWidget(recordingWidget);
 
         recordingWidget->index = info.index;
         recordingWidget->clientIndex = info.client;
         isNew = true;
+        recordingWidget->setChannelMetersEnabled(m_meterMode != METER_COMBINED);
         recordingWidget->setVolumeMeterVisible(m_showVolumeMetersCheckButton->isChecked());
+        recordingWidget->setMeterHistoryVisible(m_showMeterHistoryCheckButton->isChecked());
     }
 
     recordingWidget->updating = true;
 
     recordingWidget->type = info.client != PA_INVALID_INDEX ? RECORDING_APPLICATION : RECORDING_VIRTUAL;
+    recordingWidget->key = utils::streamKey(properties);
 
     recordingWidget->setSourceIndex(info.source);
 
+    if (moved && recordingWidget->loudnessMeter()) {
+        setLoudnessMeasurement(recordingWidget, true);
+    }
+
+    if (moved && recordingWidget->clipMeter()) {
+        setClipDetection(recordingWidget, true);
+    }
+
     if (m_clientNames.contains(info.client)) {
         recordingWidget->boldNameLabel->setText(QStringLiteral("<b>%1</b> source output client").arg(m_clientNames[info.client]));
         recordingWidget->nameLabel->setText(QString::asprintf(": %s", info.name).toHtmlEscaped());
@@ -776,21 +1540,26 @@ void MainWindow::updateRecordingWidget(const pa_source_output_info &info)
 
     recordingWidget->nameLabel->setToolTip(QString::fromUtf8(info.name));
 
-    recordingWidget->iconImage->setPixmap(utils::findIcon(info, "audio-input-microphone").pixmap(iconSize()));
+    IconCache::instance()->setPixmap(recordingWidget->iconImage, utils::findIconName(properties, "audio-input-microphone"), QStringLiteral("audio-input-microphone"), iconSize());
 
     recordingWidget->setVolume(info.volume);
     recordingWidget->muteToggleButton->setChecked(info.mute);
 
     recordingWidget->updating = false;
 
+    const InputDeviceWidget *inputDeviceWidget = m_inputDeviceWidgets.value(info.source);
+    updateSearchIndex(RECORDING_TAB, info.index, streamSearchFields(info.name, properties, inputDeviceWidget ? inputDeviceWidget->description : QByteArray()));
+
     if (isNew) {
-        updateDeviceVisibility();
+        updateDeviceVisibility(RECORDING_TAB, info.index);
     }
 }
 
 void MainWindow::updateClient(const pa_client_info &info)
 {
     m_clientNames[info.index] = QString::fromUtf8(info.name).toHtmlEscaped();
+    m_playbackList->setClientName(info.index, QString::fromUtf8(info.name));
+    m_recordingList->setClientName(info.index, QString::fromUtf8(info.name));
 
     for (PlaybackWidget *w : m_playbackWidgets) {
         if (!w) {
@@ -853,7 +1622,7 @@ bool MainWindow::createEventRoleWidget()
     m_eventRoleWidget->boldNameLabel->clear();
     m_eventRoleWidget->nameLabel->setText(tr("System Sounds"));
 
-    m_eventRoleWidget->iconImage->setPixmap(QIcon::fromTheme("multimedia-volume-control").pixmap(iconSize()));
+    IconCache::instance()->setPixmap(m_eventRoleWidget->iconImage, QStringLiteral("multimedia-volume-control"), QString(), iconSize());
 
     m_eventRoleWidget->device = "";
 
@@ -876,6 +1645,26 @@ void MainWindow::deleteEventRoleWidget()
     m_eventRoleWidget = nullptr;
 }
 
+void MainWindow::changeEvent(QEvent *event)
+{
+    if (event->type() == QEvent::ThemeChange) {
+        IconCache::instance()->invalidate(this);
+    }
+
+    QWidget::changeEvent(event);
+}
+
+bool MainWindow::eventFilter(QObject *watched, QEvent *event)
+{
+    if (watched == m_firstPaintWatched.data() && event->type() == QEvent::Paint) {
+        qCDebug(lcBulkLoad) << "First paint after the bulk load:" << m_bulkLoadTimer.elapsed() << "ms after context ready";
+        m_firstPaintWatched->removeEventFilter(this);
+        m_firstPaintWatched = nullptr;
+    }
+
+    return QWidget::eventFilter(watched, event);
+}
+
 int MainWindow::iconSize() {
     return style()->pixelMetric(QStyle::PM_ToolBarIconSize);
 }
@@ -904,7 +1693,8 @@ void MainWindow::updateRole(const pa_ext_stream_restore_info &info)
     m_eventRoleWidget->updating = false;
 
     if (is_new) {
-        updateDeviceVisibility();
+        // Not one of the playback widgets, it only keeps the tab from being empty
+        updateDeviceVisibility(PLAYBACK_TAB, PA_INVALID_INDEX);
     }
 }
 
@@ -942,31 +1732,35 @@ void MainWindow::updateDeviceInfo(const pa_ext_device_restore_info &info)
 }
 
 
-void MainWindow::updateVolumeMeter(uint32_t source_index, uint32_t sink_input_idx, double v)
+void MainWindow::updateVolumeMeter(uint32_t source_index, uint32_t sink_input_idx, const float *peaks, const pa_channel_map &map)
 {
+    float meterPeaks[PA_CHANNELS_MAX];
+    pa_channel_map meterMap;
+    MinimalStreamWidget::peaksForMeterMode(peaks, map, m_meterMode, meterPeaks, &meterMap);
+
     if (sink_input_idx != PA_INVALID_INDEX) {
         PlaybackWidget *playbackWidget;
 
         if (m_playbackWidgets.count(sink_input_idx)) {
             playbackWidget = m_playbackWidgets[sink_input_idx];
-            playbackWidget->updatePeak(v);
+            playbackWidget->updatePeaks(meterPeaks, meterMap);
         }
     } else {
         for (OutputWidget *outputWidget : m_outputWidgets) {
             if (outputWidget->monitor_index == source_index) {
-                outputWidget->updatePeak(v);
+                outputWidget->updatePeaks(meterPeaks, meterMap);
             }
         }
 
         for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
             if (inputDeviceWidget->index == source_index) {
-                inputDeviceWidget->updatePeak(v);
+                inputDeviceWidget->updatePeaks(meterPeaks, meterMap);
             }
         }
 
         for (RecordingWidget *recordingWidget : m_recordingWidgets) {
             if (recordingWidget->sourceIndex() == source_index) {
-                recordingWidget->updatePeak(v);
+                recordingWidget->updateSourcePeaks(meterPeaks, meterMap);
             }
         }
     }
@@ -998,181 +1792,542 @@ void MainWindow::setConnectionState(bool connected)
     }
 }
 
-// TODO: hack to quickly port away from glib
-static bool has_updated = true;
+void MainWindow::materializeTab(int tab)
+{
+    if (tab < 0 || tab >= DEVICE_TAB_COUNT || m_materializedTabs[tab]) {
+        return;
+    }
+
+    m_materializedTabs[tab] = true;
 
-void MainWindow::updateDeviceVisibility()
+    // Nothing can have been deferred before the context is ready
+    pa_context *context = get_context();
+    if (!context || pa_context_get_state(context) != PA_CONTEXT_READY) {
+        return;
+    }
+
+    // The input device and recording meters are fed by the input devices'
+    // monitor streams, the output device meters by the ones on the sinks'
+    // monitor sources
+    if (tab == INPUT_DEVICE_TAB || tab == RECORDING_TAB || tab == OUTPUT_TAB) {
+        if (pa_context_get_server_protocol_version(context) >= 13) {
+            for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
+                if (tab == OUTPUT_TAB && inputDeviceWidget->type != INPUT_DEVICE_MONITOR) {
+                    continue;
+                }
+                if (!inputDeviceWidget->peak) {
+                    inputDeviceWidget->peak = createMonitorStreamForSource(inputDeviceWidget->index, -1, inputDeviceWidget->channelMap);
+                }
+            }
+        }
+    }
+
+    if (m_deferredIndices[tab].isEmpty()) {
+        return;
+    }
+
+    m_deferredIndices[tab].clear();
+
+    // Only the indices were kept, the server still has everything else
+    requeryTab(DeviceTab(tab));
+}
+
+void MainWindow::requeryTab(DeviceTab tab)
 {
-    if (!has_updated) {
+    pa_context *context = get_context();
+    if (!context || pa_context_get_state(context) != PA_CONTEXT_READY) {
         return;
     }
 
-    has_updated = false;
-    QMetaObject::invokeMethod(this, &MainWindow::reallyUpdateDeviceVisibility);
+    pa_operation *o = nullptr;
+
+    switch (tab) {
+    case PLAYBACK_TAB:
+        if (!(o = pa_context_get_sink_input_info_list(context, sink_input_cb, this))) {
+            show_error(tr("pa_context_get_sink_input_info_list() failed").toUtf8().constData());
+            return;
+        }
+        break;
+    case RECORDING_TAB:
+        if (!(o = pa_context_get_source_output_info_list(context, source_output_cb, this))) {
+            show_error(tr("pa_context_get_source_output_info_list() failed").toUtf8().constData());
+            return;
+        }
+        break;
+    case OUTPUT_TAB:
+        if (!(o = pa_context_get_sink_info_list(context, sink_cb, this))) {
+            show_error(tr("pa_context_get_sink_info_list() failed").toUtf8().constData());
+            return;
+        }
+        break;
+    case INPUT_DEVICE_TAB:
+        if (!(o = pa_context_get_source_info_list(context, source_cb, this))) {
+            show_error(tr("pa_context_get_source_info_list() failed").toUtf8().constData());
+            return;
+        }
+        break;
+    case CARD_TAB:
+        if (!(o = pa_context_get_card_info_list(context, card_cb, this))) {
+            show_error(tr("pa_context_get_card_info_list() failed").toUtf8().constData());
+            return;
+        }
+        break;
+    default:
+        return;
+    }
+
+    pa_operation_unref(o);
 }
 
-void MainWindow::reallyUpdateDeviceVisibility()
+OperationBatch *MainWindow::startBatch(const QVector<DeviceTab> &tabs)
 {
-    has_updated = true;
+    OperationBatch *batch = new OperationBatch(this);
 
-    bool is_empty = true;
+    for (DeviceTab tab : tabs) {
+        m_pendingBatches[tab]++;
+    }
 
-    for (PlaybackWidget *playbackWidget : m_playbackWidgets) {
-        if (m_outputWidgets.size() > 1) {
-            playbackWidget->directionLabel->show();
-            playbackWidget->deviceButton->show();
-        } else {
-            playbackWidget->directionLabel->hide();
-            playbackWidget->deviceButton->hide();
+    connect(batch, &OperationBatch::finished, this, [this, tabs](int failures) {
+        if (failures > 0) {
+            qWarning() << failures << "operations of a batch failed";
         }
 
-        if (m_showPlaybackType == SINK_INPUT_ALL || playbackWidget->type == m_showPlaybackType) {
-            playbackWidget->show();
-            is_empty = false;
-        } else {
-            playbackWidget->hide();
+        // The change events were dropped meanwhile
+        for (DeviceTab tab : tabs) {
+            if (--m_pendingBatches[tab] == 0) {
+                requeryTab(tab);
+            }
         }
-    }
+    });
 
-    if (m_eventRoleWidget) {
-        is_empty = false;
+    return batch;
+}
+
+void MainWindow::clearSelection()
+{
+    for (OutputWidget *outputWidget : m_outputWidgets) {
+        outputWidget->setSelected(false);
+    }
+    for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
+        inputDeviceWidget->setSelected(false);
+    }
+    for (PlaybackWidget *playbackWidget : m_playbackWidgets) {
+        playbackWidget->setSelected(false);
+    }
+    for (RecordingWidget *recordingWidget : m_recordingWidgets) {
+        recordingWidget->setSelected(false);
     }
+}
 
-    if (is_empty) {
-        m_noStreamsLabel->show();
-    } else {
-        m_noStreamsLabel->hide();
+bool MainWindow::tabHasContent(DeviceTab tab) const
+{
+    if (!m_deferredIndices[tab].isEmpty()) {
+        return true;
+    }
+
+    switch (tab) {
+    case PLAYBACK_TAB:
+        return !m_playbackWidgets.isEmpty() || m_playbackList->rowCount() > 0;
+    case RECORDING_TAB:
+        return !m_recordingWidgets.isEmpty() || m_recordingList->rowCount() > 0;
+    case OUTPUT_TAB:
+        return !m_outputWidgets.isEmpty();
+    case INPUT_DEVICE_TAB:
+        return !m_inputDeviceWidgets.isEmpty();
+    case CARD_TAB:
+        return !m_cardWidgets.isEmpty();
+    default:
+        return false;
     }
+}
 
-    is_empty = true;
+// Applies visible() to either all widgets or only the given ones
+template<typename Widget, typename Visible>
+static void updateWidgetVisibility(const QHash<uint32_t, Widget *> &widgets, bool all, const QSet<uint32_t> &indices, Visible visible)
+{
+    if (all) {
+        for (Widget *widget : widgets) {
+            widget->setVisible(visible(widget));
+        }
+        return;
+    }
 
-    for (RecordingWidget *recordingWidget : m_recordingWidgets) {
-        if (m_inputDeviceWidgets.size() > 1) {
-            recordingWidget->directionLabel->show();
-            recordingWidget->deviceButton->show();
-        } else {
-            recordingWidget->directionLabel->hide();
-            recordingWidget->deviceButton->hide();
+    for (uint32_t index : indices) {
+        Widget *widget = widgets.value(index);
+        if (widget) {
+            widget->setVisible(visible(widget));
         }
+    }
+}
 
-        if (m_showRecordingType == RECORDING_ALL || recordingWidget->type == m_showRecordingType) {
-            recordingWidget->show();
-            is_empty = false;
-        } else {
-            recordingWidget->hide();
+template<typename Visible>
+static void updateRowVisibility(const StreamListModel *list, StreamListView *view, bool all, const QSet<uint32_t> &indices, Visible visible)
+{
+    if (all) {
+        for (int row = 0; row < list->rowCount(); row++) {
+            view->setRowHidden(row, !visible(list->stream(row)));
         }
+        return;
     }
 
-    if (is_empty) {
-        m_noRecsLabel->show();
-    } else {
-        m_noRecsLabel->hide();
+    for (uint32_t index : indices) {
+        const int row = list->rowForIndex(index);
+        if (row >= 0) {
+            view->setRowHidden(row, !visible(list->stream(row)));
+        }
     }
+}
 
-    is_empty = true;
+// Only has to look until the first visible one, not at every widget
+template<typename Widget>
+static bool anyShown(const QHash<uint32_t, Widget *> &widgets)
+{
+    for (const Widget *widget : widgets) {
+        if (!widget->isHidden()) {
+            return true;
+        }
+    }
+    return false;
+}
 
-    for (OutputWidget *outputWidget : m_outputWidgets) {
-        if (outputWidget->anyAvailablePorts && (m_showOutputType == OUTPUT_ALL || outputWidget->type == m_showOutputType)) {
-            outputWidget->show();
-            is_empty = false;
-        } else {
-            outputWidget->hide();
+static bool anyShown(const StreamListModel *list, const StreamListView *view)
+{
+    for (int row = 0; row < list->rowCount(); row++) {
+        if (!view->isRowHidden(row)) {
+            return true;
         }
     }
+    return false;
+}
 
-    if (is_empty) {
-        m_noOutputsLabel->show();
+bool MainWindow::matchesFilter(DeviceTab tab, uint32_t index) const
+{
+    return m_filter.isEmpty() || m_filterMatches.contains(SearchIndex::key(tab, index));
+}
+
+void MainWindow::updateSearchIndex(DeviceTab tab, uint32_t index, const QStringList &fields)
+{
+    const SearchIndex::Key key = SearchIndex::key(tab, index);
+    if (!m_searchIndex.setDocument(key, fields) || m_filter.isEmpty()) {
+        return;
+    }
+
+    const bool matched = m_filterMatches.contains(key);
+    if (m_searchIndex.matches(key, m_filter) == matched) {
+        return;
+    }
+
+    if (matched) {
+        m_filterMatches.remove(key);
     } else {
-        m_noOutputsLabel->hide();
+        m_filterMatches.insert(key);
     }
+    updateDeviceVisibility(tab, index);
+}
 
-    is_empty = true;
+void MainWindow::removeFromSearchIndex(DeviceTab tab, uint32_t index)
+{
+    const SearchIndex::Key key = SearchIndex::key(tab, index);
+    m_searchIndex.removeDocument(key);
+    m_filterMatches.remove(key);
+}
 
-    for (CardWidget *cardWidget : m_cardWidgets) {
-        cardWidget->show();
-        is_empty = false;
+void MainWindow::onFilterTextChanged(const QString &text)
+{
+    const QString filter = text.trimmed();
+    if (filter == m_filter) {
+        return;
     }
 
-    if (is_empty) {
-        m_noCardsLabel->show();
-    } else {
-        m_noCardsLabel->hide();
+    const QSet<SearchIndex::Key> matches = filter.isEmpty() ? QSet<SearchIndex::Key>() : m_searchIndex.match(filter);
+
+    // Turning the filter on or off affects everything
+    if (m_filter.isEmpty() || filter.isEmpty()) {
+        m_filter = filter;
+        m_filterMatches = matches;
+        updateDeviceVisibility();
+        return;
     }
 
-    is_empty = true;
+    // Otherwise only what started or stopped matching needs another look
+    QSet<SearchIndex::Key> changed = matches;
+    changed.subtract(m_filterMatches);
+    changed.unite(QSet<SearchIndex::Key>(m_filterMatches).subtract(matches));
 
-    for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
-        if (inputDeviceWidget->anyAvailablePorts &&
+    m_filter = filter;
+    m_filterMatches = matches;
+
+    for (SearchIndex::Key key : changed) {
+        updateDeviceVisibility(DeviceTab(SearchIndex::group(key)), SearchIndex::index(key));
+    }
+}
+
+void MainWindow::updateDeviceVisibility()
+{
+    for (int tab = 0; tab < DEVICE_TAB_COUNT; tab++) {
+        updateDeviceVisibility(DeviceTab(tab));
+    }
+}
+
+void MainWindow::updateDeviceVisibility(DeviceTab tab)
+{
+    m_dirtyTabs[tab].dirty = true;
+    m_dirtyTabs[tab].all = true;
+    m_dirtyTabs[tab].indices.clear();
+
+    if (!m_visibilityUpdatePending && !m_bulkLoading) {
+        m_visibilityUpdatePending = true;
+        QMetaObject::invokeMethod(this, &MainWindow::reallyUpdateDeviceVisibility, Qt::QueuedConnection);
+    }
+}
+
+void MainWindow::updateDeviceVisibility(DeviceTab tab, uint32_t index)
+{
+    m_dirtyTabs[tab].dirty = true;
+    if (!m_dirtyTabs[tab].all && index != PA_INVALID_INDEX) {
+        m_dirtyTabs[tab].indices.insert(index);
+    }
+
+    if (!m_visibilityUpdatePending && !m_bulkLoading) {
+        m_visibilityUpdatePending = true;
+        QMetaObject::invokeMethod(this, &MainWindow::reallyUpdateDeviceVisibility, Qt::QueuedConnection);
+    }
+}
+
+void MainWindow::beginBulkLoad()
+{
+    if (m_bulkLoading) {
+        return;
+    }
+
+    m_bulkLoading = true;
+    m_bulkLoadTimer.start();
+
+    for (QWidget *contentList : { m_streamsVBox, m_recsVBox, m_outputsVBox, m_inputDevicesVBox, m_cardsVBox }) {
+        contentList->setUpdatesEnabled(false);
+        contentList->layout()->setEnabled(false);
+    }
+}
+
+void MainWindow::endBulkLoad()
+{
+    if (!m_bulkLoading) {
+        return;
+    }
+
+    m_bulkLoading = false;
+
+    // Show/hide everything first, so the single layout pass below already
+    // sees the final set of widgets
+    if (!m_visibilityUpdatePending) {
+        reallyUpdateDeviceVisibility();
+    }
+
+    for (QWidget *contentList : { m_streamsVBox, m_recsVBox, m_outputsVBox, m_inputDevicesVBox, m_cardsVBox }) {
+        contentList->layout()->setEnabled(true);
+        contentList->layout()->activate();
+        contentList->setUpdatesEnabled(true);
+    }
+
+    if (lcBulkLoad().isDebugEnabled()) {
+        qCDebug(lcBulkLoad) << "Bulk load done:" << m_bulkLoadTimer.elapsed() << "ms after context ready";
+
+        if (m_firstPaintWatched) {
+            m_firstPaintWatched->removeEventFilter(this);
+        }
+        m_firstPaintWatched = m_notebook->currentWidget();
+        if (m_firstPaintWatched) {
+            m_firstPaintWatched->installEventFilter(this);
+        }
+    }
+}
+
+void MainWindow::reallyUpdateDeviceVisibility()
+{
+    m_visibilityUpdatePending = false;
+
+    const DirtyTab &playback = m_dirtyTabs[PLAYBACK_TAB];
+    if (playback.dirty) {
+        const bool multipleOutputs = m_outputWidgets.size() > 1;
+        updateWidgetVisibility(m_playbackWidgets, playback.all, playback.indices, [&](PlaybackWidget *playbackWidget) {
+            playbackWidget->directionLabel->setVisible(multipleOutputs);
+            playbackWidget->deviceButton->setVisible(multipleOutputs);
+
+            return (m_showPlaybackType == SINK_INPUT_ALL || playbackWidget->type == m_showPlaybackType)
+                && matchesFilter(PLAYBACK_TAB, playbackWidget->index);
+        });
+        updateRowVisibility(m_playbackList, m_playbackListView, playback.all, playback.indices, [&](const StreamListModel::Stream &stream) {
+            return (m_showPlaybackType == SINK_INPUT_ALL || stream.type == m_showPlaybackType)
+                && matchesFilter(PLAYBACK_TAB, stream.index);
+        });
+
+        const bool is_empty = !m_eventRoleWidget
+            && !anyShown(m_playbackWidgets)
+            && !anyShown(m_playbackList, m_playbackListView);
+        m_noStreamsLabel->setVisible(is_empty);
+    }
+
+    const DirtyTab &recording = m_dirtyTabs[RECORDING_TAB];
+    if (recording.dirty) {
+        const bool multipleInputDevices = m_inputDeviceWidgets.size() > 1;
+        updateWidgetVisibility(m_recordingWidgets, recording.all, recording.indices, [&](RecordingWidget *recordingWidget) {
+            recordingWidget->directionLabel->setVisible(multipleInputDevices);
+            recordingWidget->deviceButton->setVisible(multipleInputDevices);
+
+            return (m_showRecordingType == RECORDING_ALL || recordingWidget->type == m_showRecordingType)
+                && matchesFilter(RECORDING_TAB, recordingWidget->index);
+        });
+        updateRowVisibility(m_recordingList, m_recordingListView, recording.all, recording.indices, [&](const StreamListModel::Stream &stream) {
+            return (m_showRecordingType == RECORDING_ALL || stream.type == m_showRecordingType)
+                && matchesFilter(RECORDING_TAB, stream.index);
+        });
+
+        const bool is_empty = !anyShown(m_recordingWidgets)
+            && !anyShown(m_recordingList, m_recordingListView);
+        m_noRecsLabel->setVisible(is_empty);
+    }
+
+    const DirtyTab &output = m_dirtyTabs[OUTPUT_TAB];
+    if (output.dirty) {
+        updateWidgetVisibility(m_outputWidgets, output.all, output.indices, [&](OutputWidget *outputWidget) {
+            return outputWidget->anyAvailablePorts && (m_showOutputType == OUTPUT_ALL || outputWidget->type == m_showOutputType)
+                && matchesFilter(OUTPUT_TAB, outputWidget->index);
+        });
+
+        m_noOutputsLabel->setVisible(!anyShown(m_outputWidgets));
+    }
+
+    const DirtyTab &inputDevice = m_dirtyTabs[INPUT_DEVICE_TAB];
+    if (inputDevice.dirty) {
+        updateWidgetVisibility(m_inputDeviceWidgets, inputDevice.all, inputDevice.indices, [&](InputDeviceWidget *inputDeviceWidget) {
+            return inputDeviceWidget->anyAvailablePorts &&
                 (m_showInputDeviceType == INPUT_DEVICE_ALL ||
                 inputDeviceWidget->type == m_showInputDeviceType ||
-                (m_showInputDeviceType == INPUT_DEVICE_NO_MONITOR && inputDeviceWidget->type != INPUT_DEVICE_MONITOR))) {
-            inputDeviceWidget->show();
-            is_empty = false;
-        } else {
-            inputDeviceWidget->hide();
-        }
+                (m_showInputDeviceType == INPUT_DEVICE_NO_MONITOR && inputDeviceWidget->type != INPUT_DEVICE_MONITOR))
+                && matchesFilter(INPUT_DEVICE_TAB, inputDeviceWidget->index);
+        });
+
+        m_noInputDevicesLabel->setVisible(!anyShown(m_inputDeviceWidgets));
     }
 
-    if (is_empty) {
-        m_noInputDevicesLabel->show();
-    } else {
-        m_noInputDevicesLabel->hide();
+    const DirtyTab &card = m_dirtyTabs[CARD_TAB];
+    if (card.dirty) {
+        updateWidgetVisibility(m_cardWidgets, card.all, card.indices, [&](CardWidget *cardWidget) {
+            return matchesFilter(CARD_TAB, cardWidget->index);
+        });
+
+        m_noCardsLabel->setVisible(!anyShown(m_cardWidgets));
+    }
+
+    for (DirtyTab &tab : m_dirtyTabs) {
+        tab = DirtyTab();
     }
 }
 
 void MainWindow::removeCard(uint32_t index)
 {
+    removeFromSearchIndex(CARD_TAB, index);
+    m_cardPorts.remove(index);
+    m_deferredIndices[CARD_TAB].remove(index);
+
     if (!m_cardWidgets.count(index)) {
         return;
     }
 
     delete m_cardWidgets.take(index);
-    updateDeviceVisibility();
+    updateDeviceVisibility(CARD_TAB, index);
 }
 
 void MainWindow::removeOutputWidget(uint32_t index)
 {
+    removeFromSearchIndex(OUTPUT_TAB, index);
+
     if (!m_outputWidgets.count(index)) {
         return;
     }
 
     delete m_outputWidgets.take(index);
-    updateDeviceVisibility();
+    updateDeviceVisibility(OUTPUT_TAB, index);
+
+    // Playback streams only offer to move when there is somewhere to go
+    if (m_outputWidgets.size() == 1) {
+        updateDeviceVisibility(PLAYBACK_TAB);
+    }
 }
 
 void MainWindow::removeInputDevice(uint32_t index)
 {
+    removeFromSearchIndex(INPUT_DEVICE_TAB, index);
+
     if (!m_inputDeviceWidgets.count(index)) {
         return;
     }
 
     delete m_inputDeviceWidgets.take(index);
-    updateDeviceVisibility();
+    updateDeviceVisibility(INPUT_DEVICE_TAB, index);
+
+    if (m_inputDeviceWidgets.size() == 1) {
+        updateDeviceVisibility(RECORDING_TAB);
+    }
 }
 
 void MainWindow::removePlaybackWidget(uint32_t index)
 {
+    m_deferredIndices[PLAYBACK_TAB].remove(index);
+    removeFromSearchIndex(PLAYBACK_TAB, index);
+
+    if (m_playbackList->removeStream(index)) {
+        updateDeviceVisibility(PLAYBACK_TAB, index);
+        return;
+    }
+
     if (!m_playbackWidgets.count(index)) {
         return;
     }
 
-    delete m_playbackWidgets.take(index);
-    updateDeviceVisibility();
+    PlaybackWidget *playbackWidget = m_playbackWidgets.take(index);
+
+    if (playbackWidget->peak) {
+        destroyMonitorStream(playbackWidget->peak);
+        playbackWidget->peak = nullptr;
+    }
+
+    // Parked hidden and out of the layout until a stream with as many
+    // channels shows up
+    playbackWidget->hide();
+    m_streamsVBox->layout()->removeWidget(playbackWidget);
+    playbackWidget->resetForReuse();
+
+    if (!m_playbackPool.park(playbackWidget->channelMap.channels, playbackWidget)) {
+        delete playbackWidget;
+    }
+
+    updateDeviceVisibility(PLAYBACK_TAB, index);
 }
 
 void MainWindow::removeRecordingWidget(uint32_t index)
 {
+    m_deferredIndices[RECORDING_TAB].remove(index);
+    removeFromSearchIndex(RECORDING_TAB, index);
+
+    if (m_recordingList->removeStream(index)) {
+        updateDeviceVisibility(RECORDING_TAB, index);
+        return;
+    }
+
     if (!m_recordingWidgets.count(index)) {
         return;
     }
 
     delete m_recordingWidgets.take(index);
-    updateDeviceVisibility();
+    updateDeviceVisibility(RECORDING_TAB, index);
 }
 
 void MainWindow::removeClient(uint32_t index)
 {
     m_clientNames.remove(index);
+    m_playbackList->removeClient(index);
+    m_recordingList->removeClient(index);
 }
 
 void MainWindow::removeAllWidgets()
@@ -1187,6 +2342,9 @@ void MainWindow::removeAllWidgets()
     }
     m_recordingWidgets.clear();
 
+    m_playbackList->clear();
+    m_recordingList->clear();
+
     for (OutputWidget *outputWidget : m_outputWidgets) {
         outputWidget->deleteLater();
     }
@@ -1201,6 +2359,21 @@ void MainWindow::removeAllWidgets()
         cardWidget->deleteLater();
     }
     m_cardWidgets.clear();
+    m_cardPorts.clear();
+
+    m_searchIndex.clear();
+    m_filterMatches.clear();
+
+    for (QSet<uint32_t> &indices : m_deferredIndices) {
+        indices.clear();
+    }
+
+    // Their operations went down with the connection
+    qDeleteAll(findChildren<OperationBatch *>(QString(), Qt::FindDirectChildrenOnly));
+    qDeleteAll(findChildren<SceneReader *>(QString(), Qt::FindDirectChildrenOnly));
+    for (int &pendingBatches : m_pendingBatches) {
+        pendingBatches = 0;
+    }
 
     m_clientNames.clear();
     deleteEventRoleWidget();
@@ -1232,7 +2405,7 @@ void MainWindow::onOutputTypeComboBoxChanged(int index)
         m_outputTypeComboBox->setCurrentIndex((int) OUTPUT_ALL);
     }
 
-    updateDeviceVisibility();
+    updateDeviceVisibility(OUTPUT_TAB);
 }
 
 void MainWindow::onInputDeviceTypeComboBoxChanged(int index)
@@ -1245,7 +2418,7 @@ void MainWindow::onInputDeviceTypeComboBoxChanged(int index)
         m_inputDeviceTypeComboBox->setCurrentIndex((int) INPUT_DEVICE_NO_MONITOR);
     }
 
-    updateDeviceVisibility();
+    updateDeviceVisibility(INPUT_DEVICE_TAB);
 }
 
 void MainWindow::onPlaybackTypeComboBoxChanged(int index)
@@ -1258,7 +2431,7 @@ void MainWindow::onPlaybackTypeComboBoxChanged(int index)
         m_playbackTypeComboBox->setCurrentIndex((int) SINK_INPUT_CLIENT);
     }
 
-    updateDeviceVisibility();
+    updateDeviceVisibility(PLAYBACK_TAB);
 }
 
 void MainWindow::onRecordingTypeComboBoxChanged(int index)
@@ -1271,7 +2444,7 @@ void MainWindow::onRecordingTypeComboBoxChanged(int index)
         m_recordingTypeComboBox->setCurrentIndex((int) RECORDING_APPLICATION);
     }
 
-    updateDeviceVisibility();
+    updateDeviceVisibility(RECORDING_TAB);
 }
 
 
@@ -1331,6 +2504,319 @@ void MainWindow::onShowVolumeMetersCheckButtonToggled(bool toggled)
     }
 }
 
+void MainWindow::onShowMeterHistoryCheckButtonToggled(bool toggled)
+{
+    for (OutputWidget *outputWidget : m_outputWidgets) {
+        outputWidget->setMeterHistoryVisible(toggled);
+    }
+
+    for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
+        inputDeviceWidget->setMeterHistoryVisible(toggled);
+    }
+
+    for (PlaybackWidget *playbackWidget : m_playbackWidgets) {
+        playbackWidget->setMeterHistoryVisible(toggled);
+    }
+
+    for (RecordingWidget *recordingWidget : m_recordingWidgets) {
+        recordingWidget->setMeterHistoryVisible(toggled);
+    }
+}
+
+void MainWindow::onCompactStreamListsCheckButtonToggled(bool toggled)
+{
+    if (toggled == m_compactStreamLists) {
+        return;
+    }
+
+    m_compactStreamLists = toggled;
+
+    // Start over in the other mode, the server has everything we need
+    for (uint32_t index : m_playbackWidgets.keys()) {
+        removePlaybackWidget(index);
+    }
+
+    for (uint32_t index : m_recordingWidgets.keys()) {
+        removeRecordingWidget(index);
+    }
+
+    m_playbackList->clear();
+    m_recordingList->clear();
+
+    // The widgets' scroll areas stay for the system sounds and the
+    // placeholder labels, but only take the room those need
+    const QSizePolicy::Policy policy = toggled ? QSizePolicy::Maximum : QSizePolicy::Expanding;
+    for (QWidget *contentList : { m_streamsVBox, m_recsVBox }) {
+        QWidget *scrollArea = contentList->parentWidget()->parentWidget();
+        scrollArea->setSizePolicy(QSizePolicy::Expanding, policy);
+    }
+
+    m_playbackListView->setVisible(toggled);
+    m_recordingListView->setVisible(toggled);
+
+    if (!m_connected) {
+        return;
+    }
+
+    pa_operation *o;
+
+    if (!(o = pa_context_get_sink_input_info_list(get_context(), sink_input_cb, this))) {
+        show_error(tr("pa_context_get_sink_input_info_list() failed").toUtf8().constData());
+        return;
+    }
+
+    pa_operation_unref(o);
+
+    if (!(o = pa_context_get_source_output_info_list(get_context(), source_output_cb, this))) {
+        show_error(tr("pa_context_get_source_output_info_list() failed").toUtf8().constData());
+        return;
+    }
+
+    pa_operation_unref(o);
+}
+
+void MainWindow::onMeterModeComboBoxChanged(int index)
+{
+    m_meterMode = (MeterMode) index;
+
+    if (m_meterMode == (MeterMode) - 1) {
+        m_meterModeComboBox->setCurrentIndex((int) METER_COMBINED);
+        return;
+    }
+
+    const bool perChannel = m_meterMode != METER_COMBINED;
+
+    for (OutputWidget *outputWidget : m_outputWidgets) {
+        outputWidget->setChannelMetersEnabled(perChannel);
+    }
+
+    for (RecordingWidget *recordingWidget : m_recordingWidgets) {
+        recordingWidget->setChannelMetersEnabled(perChannel);
+    }
+
+    // The monitor streams carry every channel whatever the mode, only the
+    // folding in updateVolumeMeter() changes
+    for (InputDeviceWidget *inputDeviceWidget : m_inputDeviceWidgets) {
+        inputDeviceWidget->setChannelMetersEnabled(perChannel);
+    }
+
+    for (PlaybackWidget *playbackWidget : m_playbackWidgets) {
+        playbackWidget->setChannelMetersEnabled(perChannel);
+    }
+}
+
+void MainWindow::onFadeCurveComboBoxChanged(int index)
+{
+    VolumeFade::setCurve(QEasingCurve::Type(m_fadeCurveComboBox->itemData(index).toInt()));
+}
+
+void MainWindow::rebuildScenesMenu()
+{
+    m_scenesMenu->clear();
+
+    const QVector<Scene> scenes = Scene::loadAll();
+
+    for (const Scene &scene : scenes) {
+        const QString name = scene.name;
+        QAction *restore = m_scenesMenu->addAction(name, this, [this, name]() { restoreScene(name); });
+        restore->setEnabled(m_connected);
+    }
+
+    if (!scenes.isEmpty()) {
+        m_scenesMenu->addSeparator();
+    }
+
+    QAction *save = m_scenesMenu->addAction(tr("Save Current Setup..."), this, &MainWindow::saveScene);
+    save->setEnabled(m_connected);
+
+    QMenu *remove = m_scenesMenu->addMenu(tr("Delete Scene"));
+    remove->setEnabled(!scenes.isEmpty());
+    for (const Scene &scene : scenes) {
+        const QString name = scene.name;
+        remove->addAction(name, this, [this, name]() { deleteScene(name); });
+    }
+}
+
+void MainWindow::saveScene()
+{
+    bool ok = false;
+    const QString name = QInputDialog::getText(this, tr("Save Scene"), tr("Name of the scene:"), QLineEdit::Normal, QString(), &ok).trimmed();
+
+    if (!ok || name.isEmpty() || !m_connected) {
+        return;
+    }
+
+    SceneReader *reader = new SceneReader(get_context(), this);
+    connect(reader, &SceneReader::finished, this, [reader, name]() {
+        Scene scene = reader->scene();
+        scene.name = name;
+
+        // Saving under an existing name replaces that scene
+        QVector<Scene> scenes = Scene::loadAll();
+        auto it = std::find_if(scenes.begin(), scenes.end(), [&name](const Scene &s) { return s.name == name; });
+        if (it != scenes.end()) {
+            *it = scene;
+        } else {
+            scenes.append(scene);
+        }
+
+        Scene::saveAll(scenes);
+    });
+}
+
+void MainWindow::restoreScene(const QString &name)
+{
+    const QVector<Scene> scenes = Scene::loadAll();
+    auto it = std::find_if(scenes.begin(), scenes.end(), [&name](const Scene &s) { return s.name == name; });
+    if (it == scenes.end() || !m_connected) {
+        return;
+    }
+
+    const Scene target = *it;
+
+    // Compared against what the server has now, not what the tabs show
+    SceneReader *reader = new SceneReader(get_context(), this);
+    connect(reader, &SceneReader::finished, this, [this, reader, target]() {
+        OperationBatch *batch = startBatch({PLAYBACK_TAB, RECORDING_TAB, OUTPUT_TAB, INPUT_DEVICE_TAB, CARD_TAB});
+        reader->restore(target, get_context(), batch, [this, batch](bool source, const QByteArray &name, const pa_cvolume &volume) {
+            if (VolumeFade::rampDuration() <= 0) {
+                return false;
+            }
+
+            return source ? restoreVolume(m_inputDeviceWidgets, name, PA_INVALID_INDEX, volume, batch)
+                          : restoreVolume(m_outputWidgets, name, PA_INVALID_INDEX, volume, batch);
+        });
+        batch->seal();
+    });
+}
+
+void MainWindow::deleteScene(const QString &name)
+{
+    QVector<Scene> scenes = Scene::loadAll();
+    scenes.erase(std::remove_if(scenes.begin(), scenes.end(), [&name](const Scene &s) { return s.name == name; }), scenes.end());
+    Scene::saveAll(scenes);
+}
+
+void MainWindow::recordStep(const Journal::Step &step)
+{
+    m_journal.record(step);
+
+    m_undoAction->setEnabled(m_journal.canUndo());
+    m_redoAction->setEnabled(m_journal.canRedo());
+}
+
+void MainWindow::undo()
+{
+    applyStep(m_journal.undo(), false);
+}
+
+void MainWindow::redo()
+{
+    applyStep(m_journal.redo(), true);
+}
+
+void MainWindow::applyStep(const Journal::Step &step, bool redo)
+{
+    m_undoAction->setEnabled(m_journal.canUndo());
+    m_redoAction->setEnabled(m_journal.canRedo());
+
+    if (step.isEmpty() || !m_connected) {
+        return;
+    }
+
+    QVector<DeviceTab> tabs;
+    for (const Journal::Change &change : step) {
+        if (!tabs.contains(DeviceTab(change.tab))) {
+            tabs.append(DeviceTab(change.tab));
+        }
+    }
+
+    // One batch for all of it, volumes included, see holdUntilWritten()
+    OperationBatch *batch = startBatch(tabs);
+    pa_context *context = get_context();
+
+    for (const Journal::Change &change : step) {
+        const QByteArray &value = redo ? change.after : change.before;
+        pa_operation *o = nullptr;
+
+        switch (change.kind) {
+        case Journal::Change::Volume: {
+            const pa_cvolume &volume = redo ? change.volumeAfter : change.volumeBefore;
+            if (change.tab == OUTPUT_TAB) {
+                restoreVolume(m_outputWidgets, change.object, change.index, volume, batch);
+            } else if (change.tab == INPUT_DEVICE_TAB) {
+                restoreVolume(m_inputDeviceWidgets, change.object, change.index, volume, batch);
+            } else if (change.tab == PLAYBACK_TAB) {
+                restoreVolume(m_playbackWidgets, change.object, change.index, volume, batch);
+                restoreVolume(m_playbackList, change.object, change.index, volume, batch);
+            } else if (change.tab == RECORDING_TAB) {
+                restoreVolume(m_recordingWidgets, change.object, change.index, volume, batch);
+                restoreVolume(m_recordingList, change.object, change.index, volume, batch);
+            }
+            continue;
+        }
+        case Journal::Change::Mute:
+            if (change.tab == OUTPUT_TAB) {
+                restoreMute(m_outputWidgets, change.object, change.index, value == "1", batch);
+            } else if (change.tab == INPUT_DEVICE_TAB) {
+                restoreMute(m_inputDeviceWidgets, change.object, change.index, value == "1", batch);
+            } else if (change.tab == PLAYBACK_TAB) {
+                restoreMute(m_playbackWidgets, change.object, change.index, value == "1", batch);
+                restoreMute(m_playbackList, change.object, change.index, value == "1", batch);
+            } else if (change.tab == RECORDING_TAB) {
+                restoreMute(m_recordingWidgets, change.object, change.index, value == "1", batch);
+                restoreMute(m_recordingList, change.object, change.index, value == "1", batch);
+            }
+            continue;
+        case Journal::Change::Move:
+            if (change.tab == PLAYBACK_TAB) {
+                restoreRoute(m_playbackWidgets, m_outputWidgets, change.object, change.index, value, batch);
+                restoreRoute(m_playbackList, m_outputWidgets, change.object, change.index, value, batch);
+            } else if (change.tab == RECORDING_TAB) {
+                restoreRoute(m_recordingWidgets, m_inputDeviceWidgets, change.object, change.index, value, batch);
+                restoreRoute(m_recordingList, m_inputDeviceWidgets, change.object, change.index, value, batch);
+            }
+            continue;
+        case Journal::Change::Port:
+            if (value.isEmpty()) {
+                continue;
+            }
+            if (change.tab == OUTPUT_TAB) {
+                o = pa_context_set_sink_port_by_name(context, change.object.constData(), value.constData(), &OperationBatch::callback, batch);
+            } else {
+                o = pa_context_set_source_port_by_name(context, change.object.constData(), value.constData(), &OperationBatch::callback, batch);
+            }
+            break;
+        case Journal::Change::Profile:
+            if (value.isEmpty()) {
+                continue;
+            }
+            o = pa_context_set_card_profile_by_name(context, change.object.constData(), value.constData(), &OperationBatch::callback, batch);
+            break;
+        case Journal::Change::Default:
+            if (value.isEmpty()) {
+                continue;
+            }
+            if (change.tab == OUTPUT_TAB) {
+                o = pa_context_set_default_sink(context, value.constData(), &OperationBatch::callback, batch);
+            } else {
+                o = pa_context_set_default_source(context, value.constData(), &OperationBatch::callback, batch);
+            }
+            break;
+        }
+
+        if (!o) {
+            show_error(tr("Undoing or redoing the change failed").toUtf8().constData());
+            continue;
+        }
+
+        batch->add(o);
+        pa_operation_unref(o);
+    }
+
+    batch->seal();
+}
+
 void MainWindow::onPlaybackBopRequested(const uint32_t outputIndex, const pa_volume_t volume)
 {
     if (m_outputWidgets.count(outputIndex) == 0) {
@@ -22,11 +22,18 @@
 #define mainwindow_h
 
 #include "pavucontrol.h"
+#include "widgetpool.h"
+#include "cardwidget.h"
+#include "searchindex.h"
+#include "journal.h"
 #include <pulse/ext-stream-restore.h>
 #include <pulse/ext-device-restore.h>
 
 #include <QWidget>
 #include <QMap>
+#include <QSet>
+#include <QElapsedTimer>
+#include <QPointer>
 //#include "ui_mainwindow.h"
 
 class CardWidget;
@@ -35,11 +42,20 @@ class InputDeviceWidget;
 class PlaybackWidget;
 class RecordingWidget;
 class RoleWidget;
+class MinimalStreamWidget;
+class StreamListModel;
+class StreamListView;
+class OperationBatch;
 
 class QLabel;
 class QComboBox;
 class QCheckBox;
 class QTabWidget;
+class QLineEdit;
+class QSpinBox;
+class QToolButton;
+class QMenu;
+class QAction;
 class WavPlay;
 
 class MainWindow : public QWidget
@@ -57,7 +73,7 @@ public:
     void updateRecordingWidget(const pa_source_output_info &info);
     void updateClient(const pa_client_info &info);
     void updateServer(const pa_server_info &info);
-    void updateVolumeMeter(uint32_t source_index, uint32_t sink_input_index, double v);
+    void updateVolumeMeter(uint32_t source_index, uint32_t sink_input_index, const float *peaks, const pa_channel_map &map);
     void updateRole(const pa_ext_stream_restore_info &info);
     void updateDeviceInfo(const pa_ext_device_restore_info &info);
 
@@ -83,6 +99,7 @@ public:
     OutputType m_showOutputType;
     RecordingType m_showRecordingType;
     InputDeviceType m_showInputDeviceType;
+    MeterMode m_meterMode;
 
 private Q_SLOTS:
     void onPlaybackTypeComboBoxChanged(int index);
@@ -90,14 +107,64 @@ private Q_SLOTS:
     void onOutputTypeComboBoxChanged(int index);
     void onInputDeviceTypeComboBoxChanged(int index);
     void onShowVolumeMetersCheckButtonToggled(bool toggled);
+    void onMeterModeComboBoxChanged(int index);
+    void onShowMeterHistoryCheckButtonToggled(bool toggled);
+    void onCompactStreamListsCheckButtonToggled(bool toggled);
+    void onFadeCurveComboBoxChanged(int index);
+    void rebuildScenesMenu();
+    void saveScene();
+    void restoreScene(const QString &name);
+    void deleteScene(const QString &name);
+    void undo();
+    void redo();
     void onPlaybackBopRequested(const uint32_t outputIndex, const pa_volume_t volume);
+    void materializeTab(int tab);
+    void onFilterTextChanged(const QString &text);
 
 public:
+    // In notebook order
+    enum DeviceTab {
+        PLAYBACK_TAB,
+        RECORDING_TAB,
+        OUTPUT_TAB,
+        INPUT_DEVICE_TAB,
+        CARD_TAB,
+        DEVICE_TAB_COUNT
+    };
+
     void setConnectionState(bool connected);
+    // Show/hide is worked out once the current batch of events is handled,
+    // for everything, for one tab, or for a single widget (or compact list
+    // row) plus its tab's placeholder label. The widget may already be
+    // gone, then only the label is looked at.
     void updateDeviceVisibility();
+    void updateDeviceVisibility(DeviceTab tab);
+    void updateDeviceVisibility(DeviceTab tab, uint32_t index);
     void reallyUpdateDeviceVisibility();
-    pa_stream *createMonitorStreamForSource(uint32_t source_idx, uint32_t stream_idx);
+
+    // While the initial lists come in, the tabs neither relayout nor paint
+    // and visibility isn't worked out, all of that happens once at the end
+    void beginBulkLoad();
+    void endBulkLoad();
+
+    // Whether the tab has anything to show, built yet or not
+    bool tabHasContent(DeviceTab tab) const;
+
+    // Recycled playback widgets, for its hit and miss counts
+    const WidgetPool<PlaybackWidget> &playbackPool() const { return m_playbackPool; }
+
+    // Edits on a selected widget go to the rest of its tab's selection.
+    // Each edit is one batch, as are undo and redo, fades and volume writes
+    // included; change events for the tab are dropped until it's through,
+    // then the whole list is re-read once.
+    bool isBatchPending(DeviceTab tab) const { return m_pendingBatches[tab] > 0; }
+    void clearSelection();
+    pa_stream *createMonitorStreamForSource(uint32_t source_idx, uint32_t stream_idx, const pa_channel_map &deviceMap);
     void createMonitorStreamForPlayback(PlaybackWidget *playbackWidget, uint32_t sink_idx);
+    bool monitorSourceFor(MinimalStreamWidget *widget, uint32_t *source_idx, uint32_t *stream_idx);
+    void setLoudnessMeasurement(MinimalStreamWidget *widget, bool enabled);
+    void setSpectrumAnalysis(MinimalStreamWidget *widget, bool enabled);
+    void setClipDetection(MinimalStreamWidget *widget, bool enabled);
 
     RoleWidget *m_eventRoleWidget = nullptr;
 
@@ -113,6 +180,10 @@ public:
 Q_SIGNALS:
     void pulseConnected();
 
+protected:
+    void changeEvent(QEvent *event) override;
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
 private:
     int iconSize();
 
@@ -127,6 +198,14 @@ private:
     QComboBox *m_outputTypeComboBox;
     QComboBox *m_inputDeviceTypeComboBox ;
     QCheckBox *m_showVolumeMetersCheckButton;
+    QComboBox *m_meterModeComboBox;
+    QCheckBox *m_showMeterHistoryCheckButton;
+    QCheckBox *m_compactStreamListsCheckButton;
+    QSpinBox *m_muteFadeSpinBox;
+    QSpinBox *m_rampSpinBox;
+    QComboBox *m_fadeCurveComboBox;
+    QToolButton *m_scenesButton;
+    QMenu *m_scenesMenu;
 
     QLabel *m_connectingLabel;
     QLabel *m_noStreamsLabel;
@@ -142,6 +221,67 @@ private:
     QWidget *m_recsVBox;
 
     WavPlay *m_popPlayer;
+
+    // Playback and recording streams as painted rows instead of widgets
+    bool m_compactStreamLists = false;
+    StreamListModel *m_playbackList;
+    StreamListModel *m_recordingList;
+    StreamListView *m_playbackListView;
+    StreamListView *m_recordingListView;
+
+    // Short-lived streams like event sounds come and go all the time
+    WidgetPool<PlaybackWidget> m_playbackPool;
+
+    // What reallyUpdateDeviceVisibility() still has to look at
+    struct DirtyTab
+    {
+        bool dirty = false;         // at least the placeholder label
+        bool all = false;           // every widget on the tab
+        QSet<uint32_t> indices;     // or just these
+    };
+    DirtyTab m_dirtyTabs[DEVICE_TAB_COUNT];
+    bool m_visibilityUpdatePending = false;
+    bool m_bulkLoading = false;
+
+    // From the start of the bulk load (context ready) to the first paint of
+    // the current tab after it, see lcBulkLoad
+    QElapsedTimer m_bulkLoadTimer;
+    QPointer<QWidget> m_firstPaintWatched;
+
+    // Tabs that haven't been shown yet only remember which streams or
+    // cards they will have to build, output and input device widgets are
+    // always there since the other tabs look things up in them
+    bool m_materializedTabs[DEVICE_TAB_COUNT] = {};
+    QSet<uint32_t> m_deferredIndices[DEVICE_TAB_COUNT];
+
+    // Kept for every card, built or not, the device tabs need them
+    QHash<uint32_t, QHash<QByteArray, PortInfo>> m_cardPorts;
+
+    // The filter box, over the names of every built widget and compact row
+    QLineEdit *m_filterEdit;
+    SearchIndex m_searchIndex;
+    QString m_filter;
+    QSet<SearchIndex::Key> m_filterMatches;
+
+    int m_pendingBatches[DEVICE_TAB_COUNT] = {};
+
+    OperationBatch *startBatch(const QVector<DeviceTab> &tabs);
+    void requeryTab(DeviceTab tab);
+    template<typename Widget>
+    void connectEdits(Widget *widget, DeviceTab tab, const QHash<uint32_t, Widget *> &widgets);
+    void connectListEdits(StreamListModel *list, DeviceTab tab);
+
+    // What the user changed, undone and redone through the same volume
+    // writers and batches as the changes themselves
+    Journal m_journal;
+    QAction *m_undoAction;
+    QAction *m_redoAction;
+    void recordStep(const Journal::Step &step);
+    void applyStep(const Journal::Step &step, bool redo);
+
+    bool matchesFilter(DeviceTab tab, uint32_t index) const;
+    void updateSearchIndex(DeviceTab tab, uint32_t index, const QStringList &fields);
+    void removeFromSearchIndex(DeviceTab tab, uint32_t index);
 };
 
 
@@ -0,0 +1,179 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "meterdsp.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iterator>
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+
+namespace meterdsp {
+
+static unsigned gcd(unsigned a, unsigned b)
+{
+    while (b) {
+        const unsigned t = a % b;
+        a = b;
+        b = t;
+    }
+    return a;
+}
+
+void reducePeaks(const float *samples, size_t frames, unsigned channels, float *peaks)
+{
+    for (unsigned c = 0; c < channels; c++) {
+        peaks[c] = 0.f;
+    }
+
+    if (channels == 0 || channels > MAX_CHANNELS) {
+        return;
+    }
+
+    const size_t count = frames * channels;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // After lcm(channels, 4) samples the channel layout repeats on vector
+    // boundaries, so lane l of the v-th vector in every such block always
+    // holds channel (4 * v + l) % channels. That lets us keep one running
+    // maximum per vector and only sort the lanes out once at the end.
+    const unsigned period = channels * 4 / gcd(channels, 4);
+    const unsigned vectors = period / 4;
+
+    if (count >= period) {
+        const __m128 absMask = _mm_castsi128_ps(_mm_set1_epi32(0x7fffffff));
+        __m128 acc[MAX_CHANNELS];
+
+        for (unsigned v = 0; v < vectors; v++) {
+            acc[v] = _mm_setzero_ps();
+        }
+
+        for (; i + period <= count; i += period) {
+            for (unsigned v = 0; v < vectors; v++) {
+                acc[v] = _mm_max_ps(acc[v], _mm_and_ps(_mm_loadu_ps(samples + i + 4 * v), absMask));
+            }
+        }
+
+        for (unsigned v = 0; v < vectors; v++) {
+            float lanes[4];
+            _mm_storeu_ps(lanes, acc[v]);
+
+            for (unsigned l = 0; l < 4; l++) {
+                float &peak = peaks[(4 * v + l) % channels];
+                if (lanes[l] > peak) {
+                    peak = lanes[l];
+                }
+            }
+        }
+    }
+#endif
+
+    // Whatever did not fill a whole block, i is always on a frame boundary
+    for (; i < count; i += channels) {
+        for (unsigned c = 0; c < channels; c++) {
+            const float value = std::fabs(samples[i + c]);
+            if (value > peaks[c]) {
+                peaks[c] = value;
+            }
+        }
+    }
+}
+
+double sumOfSquares(const float *samples, size_t count)
+{
+    double sum = 0.;
+    size_t i = 0;
+
+#ifdef __SSE2__
+    // Blocks are short (a few thousand samples), float lanes are plenty
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+
+    for (; i + 8 <= count; i += 8) {
+        const __m128 a = _mm_loadu_ps(samples + i);
+        const __m128 b = _mm_loadu_ps(samples + i + 4);
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(a, a));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(b, b));
+    }
+
+    float lanes[4];
+    _mm_storeu_ps(lanes, _mm_add_ps(acc0, acc1));
+    sum = double(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+#endif
+
+    for (; i < count; i++) {
+        sum += double(samples[i]) * samples[i];
+    }
+
+    return sum;
+}
+
+// At least three equal samples in a row between -0.5dBFS and full scale.
+// Music that merely peaks close to full scale practically never repeats a
+// sample exactly there.
+constexpr float NEAR_FULL_SCALE = 0.944f;
+constexpr float FLAT_TOLERANCE = 1e-5f;
+constexpr unsigned FLAT_TOP_RUN = 3;
+
+bool ClipDetector::process(const float *samples, size_t frames, unsigned channels)
+{
+    const unsigned long long clipped = m_clipped;
+    const unsigned long long flatTops = m_flatTops;
+
+    if (channels == 0 || channels > MAX_CHANNELS) {
+        return false;
+    }
+
+    for (size_t i = 0; i < frames; i++) {
+        for (unsigned c = 0; c < channels; c++) {
+            const float value = std::fabs(samples[i * channels + c]);
+
+            // Runs at full scale are already counted sample by sample
+            if (value >= 1.f) {
+                m_clipped++;
+                m_runs[c] = 0;
+            } else if (value < NEAR_FULL_SCALE) {
+                m_runs[c] = 0;
+            } else if (m_runs[c] > 0 && std::fabs(value - m_last[c]) <= FLAT_TOLERANCE) {
+                // Once per run, however long it lasts
+                if (++m_runs[c] == FLAT_TOP_RUN) {
+                    m_flatTops++;
+                }
+            } else {
+                m_runs[c] = 1;
+            }
+
+            m_last[c] = value;
+        }
+    }
+
+    return m_clipped != clipped || m_flatTops != flatTops;
+}
+
+void ClipDetector::reset()
+{
+    m_clipped = 0;
+    m_flatTops = 0;
+    std::fill(std::begin(m_last), std::end(m_last), 0.f);
+    std::fill(std::begin(m_runs), std::end(m_runs), 0u);
+}
+
+}
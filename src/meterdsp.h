@@ -0,0 +1,52 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <cstddef>
+
+namespace meterdsp {
+    // PA_CHANNELS_MAX, without pulling in all of libpulse here
+    constexpr unsigned MAX_CHANNELS = 32;
+
+    // Absolute peak of each channel in a block of interleaved samples,
+    // peaks needs room for one value per channel.
+    void reducePeaks(const float *samples, size_t frames, unsigned channels, float *peaks);
+
+    double sumOfSquares(const float *samples, size_t count);
+
+    // Counts samples at or above full scale, and flat tops: runs of equal
+    // samples just below it on any one channel, which is what clipping looks
+    // like once something after it scaled the signal down a little. Only
+    // meaningful on samples at their full rate, not on block peaks.
+    class ClipDetector
+    {
+    public:
+        // Interleaved samples, returns true when anything new was counted
+        bool process(const float *samples, size_t frames, unsigned channels);
+        void reset();
+
+        unsigned long long clipped() const { return m_clipped; }
+        unsigned long long flatTops() const { return m_flatTops; }
+
+    private:
+        unsigned long long m_clipped = 0;
+        unsigned long long m_flatTops = 0;
+        float m_last[MAX_CHANNELS] = {};
+        unsigned m_runs[MAX_CHANNELS] = {};
+    };
+}
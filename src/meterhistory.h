@@ -0,0 +1,102 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// Recent peak values of one monitored object. One writer (the peak stream),
+// any number of readers (painting, export). Both sides are wait-free and
+// nothing is allocated after construction.
+class MeterHistory
+{
+public:
+    // 60 seconds of 25Hz meter updates
+    static constexpr size_t LENGTH = 60 * 25;
+
+    MeterHistory()
+    {
+        for (std::atomic<float> &value : m_values) {
+            value.store(0.f, std::memory_order_relaxed);
+        }
+    }
+
+    MeterHistory(const MeterHistory &) = delete;
+    MeterHistory &operator=(const MeterHistory &) = delete;
+
+    void push(float value)
+    {
+        const size_t written = m_written.load(std::memory_order_relaxed);
+        m_values[written & MASK].store(value, std::memory_order_relaxed);
+        m_written.store(written + 1, std::memory_order_release);
+    }
+
+    // Writer side only, readers may still see old values while it runs
+    void clear()
+    {
+        m_written.store(0, std::memory_order_release);
+    }
+
+    // Number of values ever pushed, lets readers tell if anything changed
+    size_t written() const { return m_written.load(std::memory_order_acquire); }
+
+    size_t size() const { return written() < LENGTH ? written() : LENGTH; }
+
+    // Copies the newest count values or fewer, oldest first, and returns how
+    // many were copied. Values the writer overwrote meanwhile are dropped.
+    size_t read(float *values, size_t count) const
+    {
+        const size_t end = m_written.load(std::memory_order_acquire);
+        const size_t available = end < LENGTH ? end : LENGTH;
+
+        if (count > available) {
+            count = available;
+        }
+
+        const size_t begin = end - count;
+        for (size_t i = 0; i < count; i++) {
+            values[i] = m_values[(begin + i) & MASK].load(std::memory_order_relaxed);
+        }
+
+        // Anything the writer lapped while we were copying is garbage,
+        // including the slot it may be writing right now
+        std::atomic_thread_fence(std::memory_order_acquire);
+        const size_t touched = m_written.load(std::memory_order_relaxed) - end + 1;
+        const size_t slack = CAPACITY - count;
+
+        if (touched > slack) {
+            const size_t drop = touched - slack < count ? touched - slack : count;
+            for (size_t i = drop; i < count; i++) {
+                values[i - drop] = values[i];
+            }
+            count -= drop;
+        }
+
+        return count;
+    }
+
+private:
+    // Room to spare so a reader copying LENGTH values isn't lapped at once
+    static constexpr size_t CAPACITY = 2048;
+    static constexpr size_t MASK = CAPACITY - 1;
+    static_assert(CAPACITY >= LENGTH && (CAPACITY & MASK) == 0, "capacity must be a power of two");
+
+    alignas(64) std::array<std::atomic<float>, CAPACITY> m_values;
+    alignas(64) std::atomic<size_t> m_written{0};
+};
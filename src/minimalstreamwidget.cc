@@ -20,15 +20,24 @@
 
 #include "minimalstreamwidget.h"
 #include "elidinglabel.h"
+#include "peakmeter.h"
+#include "channel.h"
+#include "loudnessmeter.h"
+#include "clipmeter.h"
+#include "spectrummeter.h"
+#include "spectrumview.h"
 
 #include <QGridLayout>
-#include <QProgressBar>
 #include <QLabel>
 #include <QDebug>
 #include <QVBoxLayout>
 #include <QToolButton>
-#include <QStyle>
-#include <QPropertyAnimation>
+#include <QAction>
+#include <QApplication>
+#include <QClipboard>
+#include <QMouseEvent>
+
+#include <cmath>
 
 /*** MinimalStreamWidget ***/
 MinimalStreamWidget::MinimalStreamWidget(QWidget *parent) :
@@ -36,6 +45,12 @@ MinimalStreamWidget::MinimalStreamWidget(QWidget *parent) :
     peak(nullptr),
     updating(false)
 {
+    pa_channel_map_init(&channelMap);
+
+    for (size_t i=0; i<PA_CHANNELS_MAX; i++) {
+        channels[i] = nullptr;
+    }
+
     setFrameShadow(QFrame::Raised);
     setFrameShape(QFrame::StyledPanel);
     mainLayout = new QVBoxLayout;
@@ -55,6 +70,14 @@ MinimalStreamWidget::MinimalStreamWidget(QWidget *parent) :
 
     topLayout->addStretch();
 
+    m_clipIndicator = new QToolButton;
+    m_clipIndicator->setIcon(QIcon::fromTheme("dialog-warning"));
+    m_clipIndicator->setText(tr("Clipping"));
+    m_clipIndicator->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
+    m_clipIndicator->setVisible(false);
+    topLayout->addWidget(m_clipIndicator);
+    connect(m_clipIndicator, &QToolButton::clicked, this, &MinimalStreamWidget::resetClipCounters);
+
     muteToggleButton = new QToolButton;
     topLayout->addWidget(muteToggleButton);
     muteToggleButton->setToolTip(tr("Mute audio"));
@@ -71,36 +94,370 @@ MinimalStreamWidget::MinimalStreamWidget(QWidget *parent) :
     channelsList = new QVBoxLayout;
     mainLayout->addLayout(channelsList);
 
-    m_peakProgressBar = new QProgressBar;
-    m_peakProgressBar->setVisible(false);
-    m_peakProgressBar->setTextVisible(false);
-    m_peakProgressBar->setMaximumHeight(4 +
-            2 * m_peakProgressBar->style()->pixelMetric(QStyle::PM_DefaultFrameWidth)
-        );
+    m_loudnessLabel = new QLabel;
+    m_loudnessLabel->setVisible(false);
+    mainLayout->addWidget(m_loudnessLabel);
+
+    m_spectrumView = new SpectrumView;
+    m_spectrumView->setVisible(false);
+    mainLayout->addWidget(m_spectrumView);
+
+    m_peakMeter = new PeakMeter;
+    m_peakMeter->setVisible(false);
+
+    m_measureLoudness = new QAction(tr("Measure Loudness"), this);
+    m_measureLoudness->setCheckable(true);
+    connect(m_measureLoudness, &QAction::toggled, this, &MinimalStreamWidget::loudnessMeasurementToggled);
+    addAction(m_measureLoudness);
+
+    m_showSpectrum = new QAction(tr("Show Spectrum"), this);
+    m_showSpectrum->setCheckable(true);
+    connect(m_showSpectrum, &QAction::toggled, this, &MinimalStreamWidget::spectrumToggled);
+    addAction(m_showSpectrum);
+
+    QAction *copyHistory = new QAction(tr("Copy Peak History"), this);
+    connect(copyHistory, &QAction::triggered, this, &MinimalStreamWidget::copyMeterHistory);
+    addAction(copyHistory);
+
+    m_detectClipping = new QAction(tr("Detect Clipping"), this);
+    m_detectClipping->setCheckable(true);
+    connect(m_detectClipping, &QAction::toggled, this, &MinimalStreamWidget::clipDetectionToggled);
+    addAction(m_detectClipping);
+
+    QAction *resetClips = new QAction(tr("Reset Clip Counters"), this);
+    connect(resetClips, &QAction::triggered, this, &MinimalStreamWidget::resetClipCounters);
+    addAction(resetClips);
+}
+
+void MinimalStreamWidget::initPeakMeter(QVBoxLayout *channelsGrid)
+{
+    channelsGrid->addWidget(m_peakMeter);
+}
+
+static bool isLeft(pa_channel_position_t position)
+{
+    switch (position) {
+    case PA_CHANNEL_POSITION_FRONT_LEFT:
+    case PA_CHANNEL_POSITION_REAR_LEFT:
+    case PA_CHANNEL_POSITION_FRONT_LEFT_OF_CENTER:
+    case PA_CHANNEL_POSITION_SIDE_LEFT:
+    case PA_CHANNEL_POSITION_TOP_FRONT_LEFT:
+    case PA_CHANNEL_POSITION_TOP_REAR_LEFT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+static bool isRight(pa_channel_position_t position)
+{
+    switch (position) {
+    case PA_CHANNEL_POSITION_FRONT_RIGHT:
+    case PA_CHANNEL_POSITION_REAR_RIGHT:
+    case PA_CHANNEL_POSITION_FRONT_RIGHT_OF_CENTER:
+    case PA_CHANNEL_POSITION_SIDE_RIGHT:
+    case PA_CHANNEL_POSITION_TOP_FRONT_RIGHT:
+    case PA_CHANNEL_POSITION_TOP_REAR_RIGHT:
+        return true;
+    default:
+        return false;
+    }
+}
+
+// Which of the peaks in a (possibly downmixed) monitor stream belongs to a
+// channel of ours, e.g. all left channels read from the left of a stereo
+// downmix. Channels that can't be placed get the loudest of all.
+float MinimalStreamWidget::peakForPosition(const float *peaks, const pa_channel_map &map, pa_channel_position_t position)
+{
+    float loudest = 0.f;
+
+    for (int i = 0; i < map.channels; i++) {
+        if (map.map[i] == position) {
+            return peaks[i];
+        }
+    }
+
+    for (int i = 0; i < map.channels; i++) {
+        if ((isLeft(position) && isLeft(map.map[i])) || (isRight(position) && isRight(map.map[i]))) {
+            return peaks[i];
+        }
+
+        loudest = qMax(loudest, peaks[i]);
+    }
 
-    m_peakAnimation = new QPropertyAnimation(m_peakProgressBar, "value", m_peakProgressBar);
-    m_peakAnimation->setDuration(100);
+    return loudest;
 }
 
-void MinimalStreamWidget::initPeakProgressBar(QVBoxLayout *channelsGrid)
+void MinimalStreamWidget::peaksForMeterMode(const float *peaks, const pa_channel_map &map, MeterMode mode, float *folded, pa_channel_map *foldedMap)
 {
-    channelsGrid->addWidget(m_peakProgressBar);
+    switch (mode) {
+    case METER_PER_CHANNEL:
+        *foldedMap = map;
+        for (int i = 0; i < map.channels; i++) {
+            folded[i] = qMin(peaks[i], 1.f);
+        }
+        return;
+    case METER_STEREO:
+        pa_channel_map_init_stereo(foldedMap);
+        folded[0] = folded[1] = 0.f;
+
+        // Center, LFE and the like go to both sides
+        for (int i = 0; i < map.channels; i++) {
+            if (!isRight(map.map[i])) {
+                folded[0] = qMax(folded[0], peaks[i]);
+            }
+            if (!isLeft(map.map[i])) {
+                folded[1] = qMax(folded[1], peaks[i]);
+            }
+        }
+
+        folded[0] = qMin(folded[0], 1.f);
+        folded[1] = qMin(folded[1], 1.f);
+        return;
+    case METER_COMBINED:
+    default:
+        pa_channel_map_init_mono(foldedMap);
+        folded[0] = 0.f;
+
+        for (int i = 0; i < map.channels; i++) {
+            folded[0] = qMax(folded[0], peaks[i]);
+        }
+
+        folded[0] = qMin(folded[0], 1.f);
+        return;
+    }
 }
 
-void MinimalStreamWidget::updatePeak(double v)
+void MinimalStreamWidget::updatePeaks(const float *peaks, const pa_channel_map &map)
 {
-    if (m_peakProgressBar->maximum() != m_peakProgressBar->width()) {
-        m_peakProgressBar->setMaximum(m_peakProgressBar->width());
+    float loudest = 0.f;
+    for (int i = 0; i < map.channels; i++) {
+        loudest = qMax(loudest, peaks[i]);
     }
 
-    int value = qRound(v * m_peakProgressBar->maximum());
-    m_peakAnimation->setEndValue(value);
-    if (!m_peakAnimation->state() != QAbstractAnimation::Running) {
-        m_peakAnimation->start();
+    m_history.push(loudest);
+
+    if (m_channelMeters) {
+        for (int i = 0; i < channelMap.channels; i++) {
+            channels[i]->peakMeter->setPeak(peakForPosition(peaks, map, channelMap.map[i]));
+        }
+
+        return;
     }
+
+    m_peakMeter->setPeak(loudest);
 }
 
 void MinimalStreamWidget::setVolumeMeterVisible(bool v)
 {
-    m_peakProgressBar->setVisible(v);
+    m_meterVisible = v;
+    updateMeterVisibility();
+}
+
+void MinimalStreamWidget::setChannelMetersEnabled(bool enabled)
+{
+    m_channelMeters = enabled;
+    updateMeterVisibility();
+}
+
+void MinimalStreamWidget::setMeterHistoryVisible(bool visible)
+{
+    m_peakMeter->setHistory(visible ? &m_history : nullptr);
+}
+
+void MinimalStreamWidget::resetMeters()
+{
+    setLoudnessMeter(nullptr);
+    setSpectrumMeter(nullptr);
+    setClipMeter(nullptr);
+
+    m_history.clear();
+
+    m_peakMeter->reset();
+    for (int i = 0; i < channelMap.channels; i++) {
+        channels[i]->peakMeter->reset();
+    }
+}
+
+void MinimalStreamWidget::setClipMeter(ClipMeter *meter)
+{
+    delete m_clipMeter;
+    m_clipMeter = meter;
+
+    if (m_clipMeter) {
+        m_clipMeter->setParent(this);
+        connect(m_clipMeter, &ClipMeter::countsChanged, this, &MinimalStreamWidget::updateClipIndicator);
+    }
+
+    {
+        const QSignalBlocker blocker(m_detectClipping);
+        m_detectClipping->setChecked(m_clipMeter);
+    }
+
+    updateClipIndicator();
+}
+
+void MinimalStreamWidget::resetClipCounters()
+{
+    if (m_clipMeter) {
+        m_clipMeter->reset();
+    }
+}
+
+void MinimalStreamWidget::updateClipIndicator()
+{
+    const unsigned long long clipped = m_clipMeter ? m_clipMeter->clipped() : 0;
+    const unsigned long long flatTops = m_clipMeter ? m_clipMeter->flatTops() : 0;
+
+    m_clipIndicator->setVisible(clipped || flatTops);
+    m_clipIndicator->setToolTip(tr("%1 samples at full scale and %2 flat-topped runs just below it since the last reset.\n"
+                                   "Click to reset.")
+                                    .arg(clipped)
+                                    .arg(flatTops));
+}
+
+// Tab separated seconds before now and peak, oldest first
+void MinimalStreamWidget::copyMeterHistory()
+{
+    QVector<float> values(int(MeterHistory::LENGTH));
+    const int count = int(m_history.read(values.data(), values.size()));
+
+    // The peak streams run at 25Hz
+    const double interval = 1. / 25.;
+
+    QString text;
+    for (int i = 0; i < count; i++) {
+        text += QStringLiteral("%1\t%2\n").arg((i + 1 - count) * interval, 0, 'f', 2).arg(values[i], 0, 'f', 4);
+    }
+
+    QApplication::clipboard()->setText(text);
+}
+
+void MinimalStreamWidget::updateMeterVisibility()
+{
+    const bool combined = m_meterVisible && !m_channelMeters;
+    const bool perChannel = m_meterVisible && m_channelMeters;
+
+    m_peakMeter->setVisible(combined);
+    if (!combined) {
+        m_peakMeter->reset();
+    }
+
+    for (int i = 0; i < channelMap.channels; i++) {
+        channels[i]->setMeterVisible(perChannel);
+        if (!perChannel) {
+            channels[i]->peakMeter->reset();
+        }
+    }
+}
+
+void MinimalStreamWidget::setLoudnessMeter(LoudnessMeter *meter)
+{
+    delete m_loudnessMeter;
+    m_loudnessMeter = meter;
+
+    if (m_loudnessMeter) {
+        m_loudnessMeter->setParent(this);
+        connect(m_loudnessMeter, &LoudnessMeter::levelsChanged, this, &MinimalStreamWidget::updateLoudnessLabel);
+    }
+
+    {
+        const QSignalBlocker blocker(m_measureLoudness);
+        m_measureLoudness->setChecked(m_loudnessMeter);
+    }
+
+    m_loudnessLabel->setVisible(m_loudnessMeter);
+    updateLoudnessLabel();
+}
+
+static QString formatLevel(double level)
+{
+    if (!std::isfinite(level)) {
+        return QStringLiteral("-\u221E");
+    }
+
+    return QString::number(level, 'f', 1);
+}
+
+void MinimalStreamWidget::updateLoudnessLabel()
+{
+    if (!m_loudnessMeter) {
+        m_loudnessLabel->clear();
+        m_loudnessLabel->setToolTip(QString());
+        return;
+    }
+
+    const LoudnessLevels &levels = m_loudnessMeter->levels();
+
+    m_loudnessLabel->setText(tr("M %1 LUFS  S %2 LUFS  TP %3 dBTP")
+                                 .arg(formatLevel(levels.momentary),
+                                      formatLevel(levels.shortTerm),
+                                      formatLevel(levels.truePeak)));
+
+    m_loudnessLabel->setToolTip(tr("Momentary loudness: %1 LUFS\n"
+                                   "Short-term loudness: %2 LUFS\n"
+                                   "True peak: %3 dBTP\n"
+                                   "RMS: %4 dBFS")
+                                    .arg(formatLevel(levels.momentary),
+                                         formatLevel(levels.shortTerm),
+                                         formatLevel(levels.truePeak),
+                                         formatLevel(levels.rms)));
+}
+
+void MinimalStreamWidget::setSpectrumMeter(SpectrumMeter *meter)
+{
+    delete m_spectrumMeter;
+    m_spectrumMeter = meter;
+
+    if (m_spectrumMeter) {
+        m_spectrumMeter->setParent(this);
+        connect(m_spectrumMeter, &SpectrumMeter::spectrumChanged, this, &MinimalStreamWidget::updateSpectrum);
+    }
+
+    {
+        const QSignalBlocker blocker(m_showSpectrum);
+        m_showSpectrum->setChecked(m_spectrumMeter);
+    }
+
+    m_spectrumView->setBands(QVector<float>(), 20., 20000.);
+    m_spectrumView->setVisible(m_spectrumMeter);
+}
+
+void MinimalStreamWidget::setSpectrumAvailable(bool available)
+{
+    if (available) {
+        addAction(m_showSpectrum);
+    } else {
+        removeAction(m_showSpectrum);
+        setSpectrumMeter(nullptr);
+    }
+}
+
+void MinimalStreamWidget::setSelected(bool selected)
+{
+    if (selected == m_selected) {
+        return;
+    }
+
+    m_selected = selected;
+
+    setFrameShadow(selected ? QFrame::Sunken : QFrame::Raised);
+    setBackgroundRole(selected ? QPalette::AlternateBase : QPalette::Window);
+    setAutoFillBackground(selected);
+}
+
+void MinimalStreamWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton && event->modifiers() & Qt::ControlModifier) {
+        setSelected(!m_selected);
+        event->accept();
+        return;
+    }
+
+    QFrame::mousePressEvent(event);
+}
+
+void MinimalStreamWidget::updateSpectrum()
+{
+    m_spectrumView->setBands(m_spectrumMeter->bands(), m_spectrumMeter->lowestFrequency(), m_spectrumMeter->highestFrequency());
 }
@@ -22,22 +22,29 @@
 #define minimalstreamwidget_h
 
 #include "pavucontrol.h"
+#include "meterhistory.h"
 #include <QGroupBox>
 #include <QFrame>
 
-class QProgressBar;
 class QLabel;
 class QVBoxLayout;
 class QHBoxLayout;
 class QToolButton;
-class QPropertyAnimation;
+class QAction;
+class QMouseEvent;
+class PeakMeter;
+class Channel;
+class LoudnessMeter;
+class ClipMeter;
+class SpectrumMeter;
+class SpectrumView;
 
 class MinimalStreamWidget : public QFrame//QGroupBox
 {
     Q_OBJECT
 public:
     MinimalStreamWidget(QWidget *parent = nullptr);
-    void initPeakProgressBar(QVBoxLayout *channelsList);
+    void initPeakMeter(QVBoxLayout *channelsList);
 
     pa_stream *peak;
 
@@ -47,8 +54,46 @@ public:
     virtual void onLockToggleButton() = 0;
     virtual void updateChannelVolume(int channel, pa_volume_t v) = 0;
 
-    void updatePeak(double v);
+    // Peaks folded into the meter mode, see peaksForMeterMode()
+    void updatePeaks(const float *peaks, const pa_channel_map &map);
+
+    // The monitor streams deliver every channel of the device, the meters
+    // show them folded into the meter mode's layout. Each folded channel is
+    // the loudest of those folded into it, clamped to full scale.
+    static void peaksForMeterMode(const float *peaks, const pa_channel_map &map, MeterMode mode, float *folded, pa_channel_map *foldedMap);
+
     void setVolumeMeterVisible(bool v);
+    void setChannelMetersEnabled(bool enabled);
+    void setMeterHistoryVisible(bool visible);
+
+    // Back to a blank slate, for widgets being recycled
+    void resetMeters();
+
+    // Combined peaks of the last minute, fed by updatePeaks()
+    const MeterHistory &meterHistory() const { return m_history; }
+
+    // Takes ownership, nullptr stops counting. Clipping shows up latched
+    // until the counters are reset.
+    void setClipMeter(ClipMeter *meter);
+    ClipMeter *clipMeter() const { return m_clipMeter; }
+    void resetClipCounters();
+
+    // Takes ownership, nullptr stops measuring
+    void setLoudnessMeter(LoudnessMeter *meter);
+    LoudnessMeter *loudnessMeter() const { return m_loudnessMeter; }
+
+    // Same for the spectrum analyzer panel
+    void setSpectrumMeter(SpectrumMeter *meter);
+    SpectrumMeter *spectrumMeter() const { return m_spectrumMeter; }
+    void setSpectrumAvailable(bool available);
+
+    // Ctrl+click toggles it; edits on a selected widget go to the whole
+    // selection of its tab
+    bool isSelected() const { return m_selected; }
+    void setSelected(bool selected);
+
+    pa_channel_map channelMap;
+    Channel *channels[PA_CHANNELS_MAX];
 
     QVBoxLayout *channelsList;
     QLabel *iconImage;
@@ -59,9 +104,43 @@ public:
     QToolButton *muteToggleButton;
     QToolButton *lockToggleButton;
 
+Q_SIGNALS:
+    void loudnessMeasurementToggled(bool enabled);
+    void clipDetectionToggled(bool enabled);
+    void spectrumToggled(bool enabled);
+
+    // The user changed this widget, for the journal and the rest of the
+    // selection
+    void volumeEdited(const pa_cvolume &before);
+    void muteEdited();
+
+protected:
+    void mousePressEvent(QMouseEvent *event) override;
+
+    void updateMeterVisibility();
+
+    static float peakForPosition(const float *peaks, const pa_channel_map &map, pa_channel_position_t position);
+
 private :
-    QPropertyAnimation *m_peakAnimation;
-    QProgressBar *m_peakProgressBar;
+    void copyMeterHistory();
+    void updateClipIndicator();
+    void updateLoudnessLabel();
+    void updateSpectrum();
+
+    PeakMeter *m_peakMeter;
+    QAction *m_measureLoudness;
+    QLabel *m_loudnessLabel;
+    LoudnessMeter *m_loudnessMeter = nullptr;
+    QAction *m_showSpectrum;
+    SpectrumView *m_spectrumView;
+    SpectrumMeter *m_spectrumMeter = nullptr;
+    bool m_meterVisible = false;
+    bool m_channelMeters = false;
+    bool m_selected = false;
+    MeterHistory m_history;
+    QAction *m_detectClipping;
+    ClipMeter *m_clipMeter = nullptr;
+    QToolButton *m_clipIndicator;
 };
 
 #endif
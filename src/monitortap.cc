@@ -0,0 +1,170 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "monitortap.h"
+
+#include <QDebug>
+
+// How far the worker may fall behind before samples are dropped
+constexpr unsigned BUFFER_SECONDS = 1;
+constexpr size_t SCRATCH_SAMPLES = 1 << 14;
+
+MonitorTap::MonitorTap(QObject *parent) :
+    QObject(parent),
+    m_worker(new QObject),
+    m_scratch(SCRATCH_SAMPLES)
+{
+    m_worker->moveToThread(&m_thread);
+    m_thread.setObjectName(QStringLiteral("MonitorTap"));
+    m_thread.start(QThread::LowPriority);
+}
+
+MonitorTap::~MonitorTap()
+{
+    stop();
+    delete m_worker;
+}
+
+bool MonitorTap::start(const QString &name, uint32_t source, uint32_t stream, const pa_channel_map &map)
+{
+    // The server resamples to this unless told to keep the device rate
+    pa_sample_spec sampleSpec;
+    sampleSpec.format = PA_SAMPLE_FLOAT32;
+    sampleSpec.rate = 48000;
+    sampleSpec.channels = map.channels;
+
+    pa_buffer_attr attributes{};
+    attributes.maxlength = (uint32_t) -1;
+    attributes.fragsize = pa_usec_to_bytes(20 * PA_USEC_PER_MSEC, &sampleSpec);
+
+    const QByteArray streamName = name.toUtf8();
+
+    m_stream = pa_stream_new(get_context(), streamName.constData(), &sampleSpec, &map);
+    if (!m_stream) {
+        show_error(tr("Failed to create monitoring stream").toUtf8().constData());
+        return false;
+    }
+
+    if (stream != PA_INVALID_INDEX) {
+        pa_stream_set_monitor_stream(m_stream, stream);
+    }
+
+    pa_stream_set_state_callback(m_stream, stateCallback, this);
+    pa_stream_set_read_callback(m_stream, readCallback, this);
+
+    const pa_stream_flags_t flags =
+            pa_stream_flags_t(PA_STREAM_DONT_MOVE | PA_STREAM_FIX_RATE | PA_STREAM_ADJUST_LATENCY |
+                              PA_STREAM_DONT_INHIBIT_AUTO_SUSPEND);
+
+    const QByteArray sourceDevice = QByteArray::number(source);
+    if (pa_stream_connect_record(m_stream, sourceDevice.constData(), &attributes, flags) < 0) {
+        show_error(tr("Failed to connect monitoring stream").toUtf8().constData());
+        pa_stream_unref(m_stream);
+        m_stream = nullptr;
+        return false;
+    }
+
+    return true;
+}
+
+void MonitorTap::stop()
+{
+    if (m_stream) {
+        pa_stream_set_state_callback(m_stream, nullptr, nullptr);
+        pa_stream_set_read_callback(m_stream, nullptr, nullptr);
+        pa_stream_disconnect(m_stream);
+        pa_stream_unref(m_stream);
+        m_stream = nullptr;
+    }
+
+    if (m_thread.isRunning()) {
+        m_thread.quit();
+        m_thread.wait();
+    }
+}
+
+void MonitorTap::stateCallback(pa_stream *stream, void *userdata)
+{
+    MonitorTap *tap = static_cast<MonitorTap *>(userdata);
+
+    if (pa_stream_get_state(stream) != PA_STREAM_READY) {
+        return;
+    }
+
+    // Only now do we know the rate the source actually runs at
+    const pa_sample_spec spec = *pa_stream_get_sample_spec(stream);
+    const pa_channel_map map = *pa_stream_get_channel_map(stream);
+
+    // Sized here rather than on the worker, no samples can have come in yet
+    tap->m_buffer.setCapacity(size_t(spec.rate) * spec.channels * BUFFER_SECONDS);
+
+    QMetaObject::invokeMethod(tap->m_worker, [tap, spec, map] {
+        tap->m_channels = spec.channels;
+        tap->configure(spec, map);
+    });
+}
+
+void MonitorTap::readCallback(pa_stream *stream, size_t length, void *userdata)
+{
+    MonitorTap *tap = static_cast<MonitorTap *>(userdata);
+
+    const void *data;
+    if (pa_stream_peek(stream, &data, &length) < 0) {
+        show_error(tr("Failed to read data from stream").toUtf8().constData());
+        return;
+    }
+
+    if (!data) {
+        if (length) {
+            pa_stream_drop(stream);
+        }
+
+        return;
+    }
+
+    if (!tap->m_buffer.push(static_cast<const float *>(data), length / sizeof(float))) {
+        qWarning() << "Monitor tap is falling behind, dropping" << length << "bytes";
+    }
+
+    pa_stream_drop(stream);
+
+    if (!tap->m_processQueued.exchange(true)) {
+        QMetaObject::invokeMethod(tap->m_worker, [tap] { tap->process(); });
+    }
+}
+
+void MonitorTap::process()
+{
+    m_processQueued = false;
+
+    if (m_channels == 0) {
+        return;
+    }
+
+    // Whole frames only, the producer never pushes partial ones
+    const size_t chunk = SCRATCH_SAMPLES - SCRATCH_SAMPLES % m_channels;
+    bool updated = false;
+
+    size_t count;
+    while ((count = m_buffer.pop(m_scratch.data(), chunk)) > 0) {
+        updated |= analyze(m_scratch.data(), count / m_channels);
+    }
+
+    if (updated) {
+        publish();
+    }
+}
@@ -0,0 +1,72 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "pavucontrol.h"
+#include "ringbuffer.h"
+
+#include <QObject>
+#include <QThread>
+#include <atomic>
+#include <vector>
+
+// Taps a source at full rate for analysis in a worker thread. The pulse
+// callbacks only copy samples into a ring buffer, subclasses do the work in
+// configure() and analyze() on the worker.
+class MonitorTap : public QObject
+{
+    Q_OBJECT
+
+public:
+    ~MonitorTap() override;
+
+    bool isValid() const { return m_stream != nullptr; }
+
+protected:
+    explicit MonitorTap(QObject *parent = nullptr);
+
+    // stream is a sink input to monitor on a sink monitor source, or
+    // PA_INVALID_INDEX for the whole source
+    bool start(const QString &name, uint32_t source, uint32_t stream, const pa_channel_map &map);
+
+    // Must be called by subclass destructors, the worker calls into them
+    void stop();
+
+    // Worker thread, once the stream is ready
+    virtual void configure(const pa_sample_spec &spec, const pa_channel_map &map) = 0;
+
+    // Worker thread, whole frames. Return true when there are new results,
+    // publish() is called after the batch.
+    virtual bool analyze(const float *samples, size_t frames) = 0;
+    virtual void publish() = 0;
+
+private:
+    static void stateCallback(pa_stream *stream, void *userdata);
+    static void readCallback(pa_stream *stream, size_t length, void *userdata);
+
+    void process();
+
+    pa_stream *m_stream = nullptr;
+    RingBuffer<float> m_buffer;
+    std::atomic<bool> m_processQueued{false};
+    unsigned m_channels = 0;
+
+    QThread m_thread;
+    QObject *m_worker;
+    std::vector<float> m_scratch;
+};
@@ -0,0 +1,89 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "operationbatch.h"
+
+#include <QPointer>
+
+OperationBatch::OperationBatch(QObject *parent) :
+    QObject(parent)
+{
+}
+
+OperationBatch::~OperationBatch()
+{
+    // Whatever is left would call back into a deleted batch
+    for (pa_operation *o : m_operations) {
+        if (pa_operation_get_state(o) == PA_OPERATION_RUNNING) {
+            pa_operation_cancel(o);
+        }
+
+        pa_operation_unref(o);
+    }
+}
+
+void OperationBatch::add(pa_operation *o)
+{
+    Q_ASSERT(!m_sealed || m_holds > 0);
+
+    m_operations.append(pa_operation_ref(o));
+    m_outstanding++;
+}
+
+void OperationBatch::seal()
+{
+    m_sealed = true;
+    finishIfDone();
+}
+
+OperationBatch::Hold OperationBatch::hold()
+{
+    m_holds++;
+
+    const QPointer<OperationBatch> batch(this);
+    return Hold(nullptr, [batch](void *) {
+        if (batch) {
+            batch->m_holds--;
+            batch->finishIfDone();
+        }
+    });
+}
+
+void OperationBatch::callback(pa_context *c, int success, void *userdata)
+{
+    Q_UNUSED(c);
+    OperationBatch *that = static_cast<OperationBatch*>(userdata);
+
+    if (!success) {
+        that->m_failures++;
+    }
+
+    that->m_outstanding--;
+    that->finishIfDone();
+}
+
+void OperationBatch::finishIfDone()
+{
+    if (!m_sealed || m_outstanding > 0 || m_holds > 0 || m_finished) {
+        return;
+    }
+
+    m_finished = true;
+    Q_EMIT finished(m_failures);
+    deleteLater();
+}
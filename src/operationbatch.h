@@ -0,0 +1,69 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+#include <memory>
+
+#include <pulse/context.h>
+#include <pulse/operation.h>
+
+// Operations on several objects, sent back to back without waiting for each
+// other, with one completion barrier once the server has answered them all.
+// Deletes itself after finished().
+class OperationBatch : public QObject
+{
+    Q_OBJECT
+public:
+    explicit OperationBatch(QObject *parent = nullptr);
+    ~OperationBatch() override;
+
+    // Keeps the batch from finishing until the last copy is gone, for
+    // operations that only get added later, e.g. once a fade is through
+    typedef std::shared_ptr<void> Hold;
+
+    // Adopts o, which must have been started with callback() and this as
+    // userdata
+    void add(pa_operation *o);
+
+    // Nothing more is going to be added, finished() follows once everything
+    // has been answered
+    void seal();
+
+    // add() stays allowed after seal() while this is held. The hold may
+    // outlive the batch.
+    Hold hold();
+
+    static void callback(pa_context *c, int success, void *userdata);
+
+Q_SIGNALS:
+    void finished(int failures);
+
+private:
+    void finishIfDone();
+
+    QVector<pa_operation *> m_operations;
+    int m_outstanding = 0;
+    int m_holds = 0;
+    int m_failures = 0;
+    bool m_sealed = false;
+    bool m_finished = false;
+};
@@ -19,6 +19,7 @@
 ***/
 
 #include "outputwidget.h"
+#include "operationbatch.h"
 
 #include <pulse/format.h>
 #include <pulse/ext-device-restore.h>
@@ -74,31 +75,22 @@ OutputWidget::OutputWidget(MainWindow *parent) :
     m_bopTimer.setSingleShot(true);
     // invalid -> automatic, thanks for the nice API libpulse
     connect(&m_bopTimer, &QTimer::timeout, this, [this]() { requestBop(index, PA_VOLUME_INVALID); });
-}
-
-void OutputWidget::onVolumeUpdateComplete(pa_context *c, int success, void *userdata)
-{
-    Q_UNUSED(c);
-    if (!success) {
-        qWarning() << "Volume change failed";
-        return;
-    }
 
     // libpulse apparently calls the callback _before_ the actual update is complete...
     // So we have a 100ms timer and hope for the best
-    OutputWidget *that = reinterpret_cast<OutputWidget*>(userdata);
-    that->m_bopTimer.start();
+    connect(&volumeWriter, &VolumeWriter::written, this, [this]() { m_bopTimer.start(); });
 }
 
 void OutputWidget::executeVolumeUpdate()
 {
     pa_operation *o;
 
-    if (!(o = pa_context_set_sink_volume_by_index(get_context(), index, &volume, &OutputWidget::onVolumeUpdateComplete, this))) {
+    if (!(o = pa_context_set_sink_volume_by_index(get_context(), index, &volume, &VolumeWriter::callback, &volumeWriter))) {
         show_error(tr("pa_context_set_sink_volume_by_index() failed").toUtf8().constData());
         return;
     }
 
+    volumeWriter.track(o);
     pa_operation_unref(o);
 }
 
@@ -110,13 +102,21 @@ void OutputWidget::onMuteToggleButton()
         return;
     }
 
+    applyMute();
+}
+
+void OutputWidget::executeMuteUpdate(bool mute, OperationBatch *batch)
+{
     pa_operation *o;
 
-    if (!(o = pa_context_set_sink_mute_by_index(get_context(), index, muteToggleButton->isChecked(), nullptr, nullptr))) {
+    if (!(o = pa_context_set_sink_mute_by_index(get_context(), index, mute, batch ? &OperationBatch::callback : nullptr, batch))) {
         show_error(tr("pa_context_set_sink_mute_by_index() failed").toUtf8().constData());
         return;
     }
 
+    if (batch) {
+        batch->add(o);
+    }
     pa_operation_unref(o);
 }
 
@@ -134,6 +134,8 @@ void OutputWidget::onDefaultToggleButton()
     }
 
     pa_operation_unref(o);
+
+    Q_EMIT defaultEdited();
 }
 
 void OutputWidget::onPortChange()
@@ -154,6 +156,8 @@ void OutputWidget::onPortChange()
         }
 
         pa_operation_unref(o);
+
+        Q_EMIT portEdited(activePort, port);
     }
 }
 
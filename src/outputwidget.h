@@ -49,6 +49,7 @@ public:
 
     void onMuteToggleButton() override;
     void executeVolumeUpdate() override;
+    void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr) override;
     void onDefaultToggleButton() override;
     void setDigital(bool);
 
@@ -60,6 +61,5 @@ protected Q_SLOTS:
     void onEncodingsChange();
 
 private:
-    static void onVolumeUpdateComplete(pa_context *c, int success, void *userdata);
     QTimer m_bopTimer;
 };
@@ -70,6 +70,7 @@ static void dec_outstanding(MainWindow *w)
 
     if (--n_outstanding <= 0) {
         // w->get_window()->set_cursor();
+        w->endBulkLoad();
         w->setConnectionState(true);
     }
 }
@@ -182,11 +183,11 @@ void source_output_cb(pa_context *, const pa_source_output_info *i, int eol, voi
              * let's open one that isn't empty */
             if (default_tab != -1) {
                 if (default_tab < 1 || default_tab > w->m_notebook->count()) {
-                    if (!w->m_playbackWidgets.empty()) {
+                    if (w->tabHasContent(MainWindow::PLAYBACK_TAB)) {
                         w->m_notebook->setCurrentIndex(0);
-                    } else if (!w->m_recordingWidgets.empty()) {
+                    } else if (w->tabHasContent(MainWindow::RECORDING_TAB)) {
                         w->m_notebook->setCurrentIndex(1);
-                    } else if (!w->m_inputDeviceWidgets.empty() && w->m_outputWidgets.empty()) {
+                    } else if (w->tabHasContent(MainWindow::INPUT_DEVICE_TAB) && !w->tabHasContent(MainWindow::OUTPUT_TAB)) {
                         w->m_notebook->setCurrentIndex(3);
                     } else {
                         w->m_notebook->setCurrentIndex(2);
@@ -364,6 +365,8 @@ void subscribe_cb(pa_context *c, pa_subscription_event_type_t t, uint32_t index,
     case PA_SUBSCRIPTION_EVENT_SINK:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
             w->removeOutputWidget(index);
+        } else if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE && w->isBatchPending(MainWindow::OUTPUT_TAB)) {
+            /* Re-read in one go once the batch is through */
         } else {
             pa_operation *o;
 
@@ -380,6 +383,8 @@ void subscribe_cb(pa_context *c, pa_subscription_event_type_t t, uint32_t index,
     case PA_SUBSCRIPTION_EVENT_SOURCE:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
             w->removeInputDevice(index);
+        } else if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE && w->isBatchPending(MainWindow::INPUT_DEVICE_TAB)) {
+            /* Re-read in one go once the batch is through */
         } else {
             pa_operation *o;
 
@@ -396,6 +401,8 @@ void subscribe_cb(pa_context *c, pa_subscription_event_type_t t, uint32_t index,
     case PA_SUBSCRIPTION_EVENT_SINK_INPUT:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
             w->removePlaybackWidget(index);
+        } else if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE && w->isBatchPending(MainWindow::PLAYBACK_TAB)) {
+            /* Re-read in one go once the batch is through */
         } else {
             pa_operation *o;
 
@@ -412,6 +419,8 @@ void subscribe_cb(pa_context *c, pa_subscription_event_type_t t, uint32_t index,
     case PA_SUBSCRIPTION_EVENT_SOURCE_OUTPUT:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
             w->removeRecordingWidget(index);
+        } else if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE && w->isBatchPending(MainWindow::RECORDING_TAB)) {
+            /* Re-read in one go once the batch is through */
         } else {
             pa_operation *o;
 
@@ -456,6 +465,8 @@ void subscribe_cb(pa_context *c, pa_subscription_event_type_t t, uint32_t index,
     case PA_SUBSCRIPTION_EVENT_CARD:
         if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_REMOVE) {
             w->removeCard(index);
+        } else if ((t & PA_SUBSCRIPTION_EVENT_TYPE_MASK) == PA_SUBSCRIPTION_EVENT_CHANGE && w->isBatchPending(MainWindow::CARD_TAB)) {
+            /* Re-read in one go once the batch is through */
         } else {
             pa_operation *o;
 
@@ -535,6 +546,7 @@ void context_state_callback(pa_context *c, void *userdata)
 
         /* Keep track of the outstanding callbacks for UI tweaks */
         n_outstanding = 0;
+        w->beginBulkLoad();
 
         if (!(o = pa_context_get_server_info(c, server_info_cb, w))) {
             show_error(QObject::tr("pa_context_get_server_info() failed").toUtf8().constData());
@@ -640,6 +652,7 @@ void context_state_callback(pa_context *c, void *userdata)
     }
 
     case PA_CONTEXT_FAILED:
+        w->endBulkLoad();
         w->setConnectionState(false);
 
         w->removeAllWidgets();
@@ -763,6 +776,12 @@ int main(int argc, char *argv[])
 
     MainWindow *mainWindow = new MainWindow(nullptr);
 
+    // Switch right away, so the requested tab is the one that gets built
+    // instead of the playback tab
+    if (default_tab >= 1 && default_tab <= mainWindow->m_notebook->count()) {
+        mainWindow->m_notebook->setCurrentIndex(default_tab - 1);
+    }
+
     if (parser.isSet(maximizeOption)) {
         mainWindow->showMaximized();
     }
@@ -60,6 +60,12 @@ enum InputDeviceType {
     INPUT_DEVICE_MONITOR,
 };
 
+enum MeterMode {
+    METER_COMBINED,
+    METER_PER_CHANNEL,
+    METER_STEREO,
+};
+
 pa_context *get_context(void);
 void show_error(const char *txt);
 
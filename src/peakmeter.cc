@@ -0,0 +1,212 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "peakmeter.h"
+#include "meterhistory.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QPolygon>
+
+#include <cmath>
+
+// Time constant for the fall-off, roughly matches the old 100ms animation
+constexpr double DECAY_MSECS = 100.;
+constexpr int FRAME_WIDTH = 1;
+constexpr int BAR_HEIGHT = 4;
+constexpr int HISTORY_HEIGHT = 20;
+
+PeakMeter::PeakMeter(QWidget *parent) :
+    QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+
+    // We fill every pixel ourselves
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+PeakMeter::~PeakMeter()
+{
+    FrameTicker::instance()->unschedule(this);
+}
+
+QSize PeakMeter::sizeHint() const
+{
+    return QSize(100, minimumSizeHint().height());
+}
+
+QSize PeakMeter::minimumSizeHint() const
+{
+    const int height = m_history ? HISTORY_HEIGHT : BAR_HEIGHT;
+    return QSize(2 * FRAME_WIDTH, height + 2 * FRAME_WIDTH);
+}
+
+void PeakMeter::setHistory(const MeterHistory *history)
+{
+    if (history == m_history) {
+        return;
+    }
+
+    m_history = history;
+
+    // Sized once here so painting never allocates
+    m_historyValues.resize(m_history ? MeterHistory::LENGTH : 0);
+
+    updateGeometry();
+    update();
+}
+
+void PeakMeter::setPeak(double value)
+{
+    value = qBound(0., value, 1.);
+
+    const qint64 now = FrameTicker::instance()->now();
+    const double current = levelAt(now);
+
+    // Rise immediately, fall off smoothly from wherever we are now
+    m_start = qMax(value, current);
+    m_target = value;
+    m_startTime = now;
+
+    if (isVisible()) {
+        FrameTicker::instance()->schedule(this);
+
+        // There's a new value in the history as well
+        if (m_history) {
+            update();
+        }
+    }
+}
+
+void PeakMeter::reset()
+{
+    FrameTicker::instance()->unschedule(this);
+
+    m_start = m_target = 0.;
+    m_paintedWidth = 0;
+    update();
+}
+
+double PeakMeter::levelAt(qint64 msecs) const
+{
+    const double elapsed = msecs - m_startTime;
+    return m_target + (m_start - m_target) * std::exp(-elapsed / DECAY_MSECS);
+}
+
+QRect PeakMeter::barRect() const
+{
+    return rect().adjusted(FRAME_WIDTH, FRAME_WIDTH, -FRAME_WIDTH, -FRAME_WIDTH);
+}
+
+int PeakMeter::barWidth(double level) const
+{
+    return qRound(level * barRect().width());
+}
+
+bool PeakMeter::advanceFrame(qint64 msecs)
+{
+    if (!isVisible()) {
+        return false;
+    }
+
+    const int width = barWidth(levelAt(msecs));
+
+    if (width != m_paintedWidth) {
+        const QRect bar = barRect();
+        const int height = m_history ? BAR_HEIGHT : bar.height();
+
+        // Only the strip between the old and the new end of the bar changed
+        update(bar.x() + qMin(width, m_paintedWidth), bar.bottom() + 1 - height, qAbs(width - m_paintedWidth), height);
+        m_paintedWidth = width;
+    }
+
+    return width != barWidth(m_target);
+}
+
+void PeakMeter::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+
+    const QRect dirty = event->rect();
+    const QRect bar = barRect();
+
+    if (!bar.contains(dirty)) {
+        painter.setPen(palette().color(QPalette::Mid));
+        painter.drawRect(rect().adjusted(0, 0, -1, -1));
+    }
+
+    if (m_history) {
+        // The level runs along the bottom, the history fills the rest
+        painter.fillRect(bar, palette().color(QPalette::Base));
+        paintHistory(painter, bar.adjusted(0, 0, 0, -BAR_HEIGHT));
+        painter.fillRect(bar.x(), bar.bottom() + 1 - BAR_HEIGHT, m_paintedWidth, BAR_HEIGHT, palette().color(QPalette::Highlight));
+        return;
+    }
+
+    const QRect filled(bar.x(), bar.y(), m_paintedWidth, bar.height());
+    painter.fillRect(filled & dirty, palette().color(QPalette::Highlight));
+    painter.fillRect(bar.adjusted(m_paintedWidth, 0, 0, 0) & dirty, palette().color(QPalette::Base));
+}
+
+void PeakMeter::paintHistory(QPainter &painter, const QRect &area)
+{
+    const int count = int(m_history->read(m_historyValues.data(), m_historyValues.size()));
+    const int length = int(MeterHistory::LENGTH);
+
+    if (count == 0 || area.width() <= 0 || area.height() <= 0) {
+        return;
+    }
+
+    // The full minute always spans the width, newest on the right, so the
+    // line doesn't stretch while the history fills up
+    const int missing = length - count;
+    QPolygon polygon;
+    polygon.reserve(area.width() + 2);
+    polygon << QPoint(area.right() + 1, area.bottom() + 1);
+
+    for (int x = area.width() - 1; x >= 0; x--) {
+        const int first = x * length / area.width() - missing;
+        const int last = (x + 1) * length / area.width() - missing;
+
+        if (last <= 0) {
+            break;
+        }
+
+        float loudest = 0.f;
+        for (int i = qMax(first, 0); i < last; i++) {
+            loudest = qMax(loudest, m_historyValues[i]);
+        }
+
+        polygon << QPoint(area.x() + x, area.bottom() + 1 - qRound(loudest * area.height()));
+    }
+
+    polygon << QPoint(polygon.last().x(), area.bottom() + 1);
+
+    QColor color = palette().color(QPalette::Highlight);
+    color.setAlpha(96);
+
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(color);
+    painter.drawPolygon(polygon);
+}
+
+void PeakMeter::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+
+    m_paintedWidth = barWidth(levelAt(FrameTicker::instance()->now()));
+}
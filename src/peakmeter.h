@@ -0,0 +1,69 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "frameticker.h"
+
+#include <QWidget>
+#include <vector>
+
+class MeterHistory;
+
+// Self-painted level bar, cheaper than going through QProgressBar and the
+// style for every peak update.
+class PeakMeter : public QWidget, public FrameTicker::Client
+{
+    Q_OBJECT
+
+public:
+    explicit PeakMeter(QWidget *parent = nullptr);
+    ~PeakMeter() override;
+
+    void setPeak(double value);
+    void reset();
+
+    // Draws the recent history as a sparkline behind the bar, nullptr to
+    // turn it off again. Not owned.
+    void setHistory(const MeterHistory *history);
+
+    bool advanceFrame(qint64 msecs) override;
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
+
+private:
+    double levelAt(qint64 msecs) const;
+    int barWidth(double level) const;
+    QRect barRect() const;
+    void paintHistory(QPainter &painter, const QRect &area);
+
+    // The displayed level falls from m_start towards m_target, starting at
+    // m_startTime, so it can be evaluated for any frame without stepping.
+    double m_start = 0.;
+    double m_target = 0.;
+    qint64 m_startTime = 0;
+
+    int m_paintedWidth = 0;
+
+    const MeterHistory *m_history = nullptr;
+    std::vector<float> m_historyValues;
+};
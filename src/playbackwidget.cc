@@ -21,6 +21,7 @@
 #include "playbackwidget.h"
 
 #include "mainwindow.h"
+#include "operationbatch.h"
 #include "outputwidget.h"
 
 #include <QMenu>
@@ -64,14 +65,7 @@ public slots:
         /*if (!mpMainWindow->sinkWidgets.count(widget->index))
           return;*/
 
-        pa_operation *o;
-
-        if (!(o = pa_context_move_sink_input_by_index(get_context(), widget->index, index, nullptr, nullptr))) {
-            show_error(tr("pa_context_move_sink_input_by_index() failed").toUtf8().constData());
-            return;
-        }
-
-        pa_operation_unref(o);
+        widget->moveTo(index);
     }
 };
 
@@ -83,6 +77,8 @@ PlaybackWidget::PlaybackWidget(MainWindow *parent) :
     directionLabel->setText(tr("<i>on</i>"));
 
     terminate->setText(tr("Terminate Playback"));
+
+    connect(&volumeWriter, &VolumeWriter::written, this, [this]() { emit requestBop(mSinkIndex, maxVolume); });
 }
 
 void PlaybackWidget::setPlaybackIndex(uint32_t idx)
@@ -102,29 +98,18 @@ uint32_t PlaybackWidget::playbackIndex()
     return mSinkIndex;
 }
 
-static void onVolumeChanged(pa_context *c, int success, void *userdata)
-{
-    Q_UNUSED(c);
-    if (!success) {
-        qWarning() << "Volume change failed";
-        return;
-    }
-
-    PlaybackWidget *that = reinterpret_cast<PlaybackWidget*>(userdata);
-    emit that->requestBop(that->mSinkIndex, that->maxVolume);
-}
-
 void PlaybackWidget::executeVolumeUpdate()
 {
     pa_operation *o;
 
     maxVolume = pa_cvolume_max(&volume);;
 
-    if (!(o = pa_context_set_sink_input_volume(get_context(), index, &volume, onVolumeChanged, this))) {
+    if (!(o = pa_context_set_sink_input_volume(get_context(), index, &volume, &VolumeWriter::callback, &volumeWriter))) {
         show_error(tr("pa_context_set_sink_input_volume() failed").toUtf8().constData());
         return;
     }
 
+    volumeWriter.track(o);
     pa_operation_unref(o);
 }
 
@@ -136,13 +121,44 @@ void PlaybackWidget::onMuteToggleButton()
         return;
     }
 
+    applyMute();
+}
+
+void PlaybackWidget::executeMuteUpdate(bool mute, OperationBatch *batch)
+{
     pa_operation *o;
 
-    if (!(o = pa_context_set_sink_input_mute(get_context(), index, muteToggleButton->isChecked(), nullptr, nullptr))) {
+    if (!(o = pa_context_set_sink_input_mute(get_context(), index, mute, batch ? &OperationBatch::callback : nullptr, batch))) {
         show_error(tr("pa_context_set_sink_input_mute() failed").toUtf8().constData());
         return;
     }
 
+    if (batch) {
+        batch->add(o);
+    }
+    pa_operation_unref(o);
+}
+
+void PlaybackWidget::moveTo(uint32_t sinkIndex, OperationBatch *batch)
+{
+    if (!batch) {
+        Q_EMIT moveEdited(sinkIndex);
+
+        if (isSelected()) {
+            return;
+        }
+    }
+
+    pa_operation *o;
+
+    if (!(o = pa_context_move_sink_input_by_index(get_context(), index, sinkIndex, batch ? &OperationBatch::callback : nullptr, batch))) {
+        show_error(tr("pa_context_move_sink_input_by_index() failed").toUtf8().constData());
+        return;
+    }
+
+    if (batch) {
+        batch->add(o);
+    }
     pa_operation_unref(o);
 }
 
@@ -45,10 +45,14 @@ public:
     uint32_t playbackIndex();
 
     void executeVolumeUpdate() override;
+    void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr) override;
     void onMuteToggleButton() override;
     void onDeviceChangePopup() override;
     void onKill() override;
 
+    // Without a batch a selected widget leaves it to the selection
+    void moveTo(uint32_t sinkIndex, OperationBatch *batch = nullptr);
+
 signals:
     void requestBop(const int outputIndex, const pa_volume_t volume);
 
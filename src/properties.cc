@@ -0,0 +1,89 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "properties.h"
+
+#include <QByteArray>
+#include <QHash>
+
+#include <cstring>
+
+// The same few values ("usb", "music", icon names, ...) come back with every
+// reply, so they get shared instead of converted and allocated each time.
+// Only ever used from the main loop, so no locking.
+static QString intern(const char *value)
+{
+    static QHash<QByteArray, QString> pool;
+
+    // Descriptions can be anything, don't let them pile up forever
+    static const int MAX_POOL_SIZE = 1024;
+
+    const QByteArray key = QByteArray::fromRawData(value, int(strlen(value)));
+    auto it = pool.constFind(key);
+    if (it != pool.constEnd()) {
+        return it.value();
+    }
+
+    if (pool.size() >= MAX_POOL_SIZE) {
+        pool.clear();
+    }
+
+    // fromRawData() doesn't own the bytes, the stored key needs a real copy
+    const QString string = QString::fromUtf8(value);
+    pool.insert(QByteArray(value), string);
+    return string;
+}
+
+Properties Properties::decode(const pa_proplist *proplist)
+{
+    static const QHash<QByteArray, QString Properties::*> fields({
+        {PA_PROP_MEDIA_ICON_NAME, &Properties::mediaIconName},
+        {PA_PROP_WINDOW_ICON_NAME, &Properties::windowIconName},
+        {PA_PROP_APPLICATION_ICON_NAME, &Properties::applicationIconName},
+        {PA_PROP_MEDIA_ROLE, &Properties::mediaRole},
+        {PA_PROP_APPLICATION_NAME, &Properties::applicationName},
+        {PA_PROP_APPLICATION_ID, &Properties::applicationId},
+        {PA_PROP_APPLICATION_PROCESS_BINARY, &Properties::applicationProcessBinary},
+        {"module-stream-restore.id", &Properties::streamRestoreId},
+        {PA_PROP_DEVICE_BUS, &Properties::deviceBus},
+        {PA_PROP_DEVICE_VENDOR_ID, &Properties::deviceVendorId},
+        {PA_PROP_DEVICE_DESCRIPTION, &Properties::deviceDescription},
+        {PA_PROP_DEVICE_ICON_NAME, &Properties::deviceIconName},
+    });
+
+    Properties properties;
+    if (!proplist) {
+        return properties;
+    }
+
+    void *state = nullptr;
+    while (const char *key = pa_proplist_iterate(proplist, &state)) {
+        const auto field = fields.constFind(QByteArray::fromRawData(key, int(strlen(key))));
+        if (field == fields.constEnd()) {
+            continue;
+        }
+
+        // Binary values (e.g. icons) have no string form, those are skipped
+        const char *value = pa_proplist_gets(proplist, key);
+        if (value) {
+            properties.*field.value() = intern(value);
+        }
+    }
+
+    return properties;
+}
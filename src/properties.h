@@ -0,0 +1,43 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QString>
+
+#include <pulse/proplist.h>
+
+// The handful of proplist entries we actually look at, decoded in a single
+// pass over the list instead of one pa_proplist_gets() per question asked.
+struct Properties
+{
+    QString mediaIconName;
+    QString windowIconName;
+    QString applicationIconName;
+    QString mediaRole;
+    QString applicationName;
+    QString applicationId;
+    QString applicationProcessBinary;
+    QString streamRestoreId;
+    QString deviceBus;
+    QString deviceVendorId;
+    QString deviceDescription;
+    QString deviceIconName;
+
+    static Properties decode(const pa_proplist *proplist);
+};
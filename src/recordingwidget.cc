@@ -20,6 +20,7 @@
 
 #include "recordingwidget.h"
 #include "mainwindow.h"
+#include "operationbatch.h"
 #include "inputdevicewidget.h"
 #include <QMenu>
 #include <QLabel>
@@ -61,14 +62,7 @@ public slots:
         /*if (!mpMainWindow->sourceWidgets.count(widget->index))
           return;*/
 
-        pa_operation *o;
-
-        if (!(o = pa_context_move_source_output_by_index(get_context(), widget->index, index, nullptr, nullptr))) {
-            show_error(tr("pa_context_move_source_output_by_index() failed").toUtf8().constData());
-            return;
-        }
-
-        pa_operation_unref(o);
+        widget->moveTo(index);
     }
 };
 
@@ -79,6 +73,9 @@ RecordingWidget::RecordingWidget(MainWindow *parent) :
 
     directionLabel->setText(tr("<i>from</i>"));
 
+    // Source outputs can't be tapped on their own
+    setSpectrumAvailable(false);
+
     terminate->setText(tr("Terminate Recording"));
 }
 
@@ -99,15 +96,46 @@ uint32_t RecordingWidget::sourceIndex()
     return mSourceIndex;
 }
 
+// Source outputs can't be monitored on their own, but their volume is applied
+// on top of the source, so the source peaks we already capture for the input
+// device are enough to work out ours.
+void RecordingWidget::updateSourcePeaks(const float *peaks, const pa_channel_map &map)
+{
+    float scaled[PA_CHANNELS_MAX] = {};
+
+    // The peaks already have the source volume applied, with flat volumes
+    // ours includes it as well, so only what we add on top of it counts
+    pa_cvolume relative = volume;
+    InputDeviceWidget *source = mpMainWindow->m_inputDeviceWidgets.value(mSourceIndex);
+    if (source && source->flatVolume && pa_cvolume_valid(&source->volume)) {
+        pa_cvolume sourceVolume = source->volume;
+        if (pa_cvolume_remap(&sourceVolume, &source->channelMap, &channelMap) && sourceVolume.channels == volume.channels) {
+            pa_sw_cvolume_divide(&relative, &volume, &sourceVolume);
+        }
+    }
+
+    if (!muteToggleButton->isChecked()) {
+        for (int i = 0; i < channelMap.channels; i++) {
+            const pa_volume_t v = i < relative.channels ? relative.values[i] : PA_VOLUME_NORM;
+            const double linear = pa_sw_volume_to_linear(v);
+
+            scaled[i] = qMin(1.f, float(peakForPosition(peaks, map, channelMap.map[i]) * linear));
+        }
+    }
+
+    updatePeaks(scaled, channelMap);
+}
+
 void RecordingWidget::executeVolumeUpdate()
 {
     pa_operation *o;
 
-    if (!(o = pa_context_set_source_output_volume(get_context(), index, &volume, nullptr, nullptr))) {
+    if (!(o = pa_context_set_source_output_volume(get_context(), index, &volume, &VolumeWriter::callback, &volumeWriter))) {
         show_error(tr("pa_context_set_source_output_volume() failed").toUtf8().constData());
         return;
     }
 
+    volumeWriter.track(o);
     pa_operation_unref(o);
 }
 
@@ -119,13 +147,44 @@ void RecordingWidget::onMuteToggleButton()
         return;
     }
 
+    applyMute();
+}
+
+void RecordingWidget::executeMuteUpdate(bool mute, OperationBatch *batch)
+{
     pa_operation *o;
 
-    if (!(o = pa_context_set_source_output_mute(get_context(), index, muteToggleButton->isChecked(), nullptr, nullptr))) {
+    if (!(o = pa_context_set_source_output_mute(get_context(), index, mute, batch ? &OperationBatch::callback : nullptr, batch))) {
         show_error(tr("pa_context_set_source_output_mute() failed").toUtf8().constData());
         return;
     }
 
+    if (batch) {
+        batch->add(o);
+    }
+    pa_operation_unref(o);
+}
+
+void RecordingWidget::moveTo(uint32_t sourceIndex, OperationBatch *batch)
+{
+    if (!batch) {
+        Q_EMIT moveEdited(sourceIndex);
+
+        if (isSelected()) {
+            return;
+        }
+    }
+
+    pa_operation *o;
+
+    if (!(o = pa_context_move_source_output_by_index(get_context(), index, sourceIndex, batch ? &OperationBatch::callback : nullptr, batch))) {
+        show_error(tr("pa_context_move_source_output_by_index() failed").toUtf8().constData());
+        return;
+    }
+
+    if (batch) {
+        batch->add(o);
+    }
     pa_operation_unref(o);
 }
 
@@ -39,11 +39,19 @@ public:
     uint32_t index, clientIndex;
     void setSourceIndex(uint32_t idx);
     uint32_t sourceIndex();
+
+    // Peaks of the whole source, scaled to what this stream gets out of it
+    void updateSourcePeaks(const float *peaks, const pa_channel_map &map);
+
     virtual void executeVolumeUpdate();
+    virtual void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr);
     virtual void onMuteToggleButton();
     virtual void onDeviceChangePopup();
     virtual void onKill();
 
+    // Without a batch a selected widget leaves it to the selection
+    void moveTo(uint32_t sourceIndex, OperationBatch *batch = nullptr);
+
 private:
     uint32_t mSourceIndex;
 
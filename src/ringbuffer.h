@@ -0,0 +1,116 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// Single producer, single consumer queue for sample data. The pulse main
+// loop writes, a worker thread reads, neither ever blocks the other.
+template<typename T>
+class RingBuffer
+{
+public:
+    RingBuffer() = default;
+
+    explicit RingBuffer(size_t capacity)
+    {
+        setCapacity(capacity);
+    }
+
+    // Rounded up to a power of two, drops whatever is queued. Neither side
+    // may be using the buffer meanwhile.
+    void setCapacity(size_t capacity)
+    {
+        size_t size = 1;
+        while (size < capacity) {
+            size <<= 1;
+        }
+
+        m_data.assign(size, T());
+        m_data.shrink_to_fit();
+        m_mask = size - 1;
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+    }
+
+    size_t capacity() const { return m_data.size(); }
+
+    size_t available() const
+    {
+        return m_head.load(std::memory_order_acquire) - m_tail.load(std::memory_order_relaxed);
+    }
+
+    // Writes all of it or nothing, so readers always see whole frames
+    bool push(const T *values, size_t count)
+    {
+        const size_t head = m_head.load(std::memory_order_relaxed);
+        const size_t tail = m_tail.load(std::memory_order_acquire);
+
+        if (capacity() - (head - tail) < count) {
+            return false;
+        }
+
+        copyIn(head, values, count);
+        m_head.store(head + count, std::memory_order_release);
+        return true;
+    }
+
+    size_t pop(T *values, size_t count)
+    {
+        const size_t tail = m_tail.load(std::memory_order_relaxed);
+        const size_t head = m_head.load(std::memory_order_acquire);
+
+        if (count > head - tail) {
+            count = head - tail;
+        }
+
+        copyOut(tail, values, count);
+        m_tail.store(tail + count, std::memory_order_release);
+        return count;
+    }
+
+private:
+    void copyIn(size_t position, const T *values, size_t count)
+    {
+        const size_t start = position & m_mask;
+        const size_t first = std::min(count, capacity() - start);
+
+        memcpy(m_data.data() + start, values, first * sizeof(T));
+        memcpy(m_data.data(), values + first, (count - first) * sizeof(T));
+    }
+
+    void copyOut(size_t position, T *values, size_t count) const
+    {
+        const size_t start = position & m_mask;
+        const size_t first = std::min(count, capacity() - start);
+
+        memcpy(values, m_data.data() + start, first * sizeof(T));
+        memcpy(values + first, m_data.data(), (count - first) * sizeof(T));
+    }
+
+    std::vector<T> m_data;
+    size_t m_mask = 0;
+
+    // On separate cache lines so the two threads don't keep stealing it
+    alignas(64) std::atomic<size_t> m_head{0};
+    alignas(64) std::atomic<size_t> m_tail{0};
+};
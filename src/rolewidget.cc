@@ -62,11 +62,12 @@ void RoleWidget::executeVolumeUpdate()
 
     pa_operation *o;
 
-    if (!(o = pa_ext_stream_restore_write(get_context(), PA_UPDATE_REPLACE, &info, 1, true, nullptr, nullptr))) {
+    if (!(o = pa_ext_stream_restore_write(get_context(), PA_UPDATE_REPLACE, &info, 1, true, &VolumeWriter::callback, &volumeWriter))) {
         show_error(tr("pa_ext_stream_restore_write() failed").toUtf8().constData());
         return;
     }
 
+    volumeWriter.track(o);
     pa_operation_unref(o);
 }
 
@@ -0,0 +1,456 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "scene.h"
+
+#include "pavucontrol.h"
+#include "operationbatch.h"
+#include "properties.h"
+#include "utils.h"
+
+#include <QSettings>
+#include <QVariantList>
+
+static void writeDevices(QSettings &config, const QString &key, const QVector<Scene::Device> &devices)
+{
+    config.beginWriteArray(key, devices.size());
+    for (int i = 0; i < devices.size(); i++) {
+        const Scene::Device &device = devices[i];
+        config.setArrayIndex(i);
+        config.setValue(QStringLiteral("name"), device.name);
+        config.setValue(QStringLiteral("port"), device.port);
+        config.setValue(QStringLiteral("mute"), device.mute);
+
+        QVariantList volume;
+        for (int channel = 0; channel < device.volume.channels; channel++) {
+            volume.append(device.volume.values[channel]);
+        }
+        config.setValue(QStringLiteral("volume"), volume);
+    }
+    config.endArray();
+}
+
+static QVector<Scene::Device> readDevices(QSettings &config, const QString &key)
+{
+    QVector<Scene::Device> devices;
+
+    const int count = config.beginReadArray(key);
+    for (int i = 0; i < count; i++) {
+        config.setArrayIndex(i);
+
+        Scene::Device device;
+        device.name = config.value(QStringLiteral("name")).toByteArray();
+        device.port = config.value(QStringLiteral("port")).toByteArray();
+        device.mute = config.value(QStringLiteral("mute")).toBool();
+
+        const QVariantList volume = config.value(QStringLiteral("volume")).toList();
+        pa_cvolume_init(&device.volume);
+        device.volume.channels = qMin<int>(volume.size(), PA_CHANNELS_MAX);
+        for (int channel = 0; channel < device.volume.channels; channel++) {
+            device.volume.values[channel] = PA_CLAMP_VOLUME(volume[channel].toUInt());
+        }
+
+        if (!device.name.isEmpty() && pa_cvolume_valid(&device.volume)) {
+            devices.append(device);
+        }
+    }
+    config.endArray();
+
+    return devices;
+}
+
+static void writeRoutes(QSettings &config, const QString &key, const QVector<QPair<QByteArray, QByteArray>> &routes)
+{
+    config.beginWriteArray(key, routes.size());
+    for (int i = 0; i < routes.size(); i++) {
+        config.setArrayIndex(i);
+        config.setValue(QStringLiteral("from"), routes[i].first);
+        config.setValue(QStringLiteral("to"), routes[i].second);
+    }
+    config.endArray();
+}
+
+static QVector<QPair<QByteArray, QByteArray>> readRoutes(QSettings &config, const QString &key)
+{
+    QVector<QPair<QByteArray, QByteArray>> routes;
+
+    const int count = config.beginReadArray(key);
+    for (int i = 0; i < count; i++) {
+        config.setArrayIndex(i);
+        routes.append(qMakePair(config.value(QStringLiteral("from")).toByteArray(), config.value(QStringLiteral("to")).toByteArray()));
+    }
+    config.endArray();
+
+    return routes;
+}
+
+template<typename T>
+static const T *findByName(const QVector<T> &items, const QByteArray &name)
+{
+    for (const T &item : items) {
+        if (item.name == name) {
+            return &item;
+        }
+    }
+
+    return nullptr;
+}
+
+template<typename T>
+static const QByteArray *findValue(const QVector<QPair<T, QByteArray>> &pairs, const T &key)
+{
+    for (const QPair<T, QByteArray> &pair : pairs) {
+        if (pair.first == key) {
+            return &pair.second;
+        }
+    }
+
+    return nullptr;
+}
+
+QVector<Scene> Scene::loadAll()
+{
+    QVector<Scene> scenes;
+    QSettings config;
+
+    const int count = config.beginReadArray(QStringLiteral("scenes"));
+    for (int i = 0; i < count; i++) {
+        config.setArrayIndex(i);
+
+        Scene scene;
+        scene.name = config.value(QStringLiteral("name")).toString();
+        scene.defaultSink = config.value(QStringLiteral("defaultSink")).toByteArray();
+        scene.defaultSource = config.value(QStringLiteral("defaultSource")).toByteArray();
+        scene.cardProfiles = readRoutes(config, QStringLiteral("cardProfiles"));
+        scene.sinks = readDevices(config, QStringLiteral("sinks"));
+        scene.sources = readDevices(config, QStringLiteral("sources"));
+        scene.playbackRoutes = readRoutes(config, QStringLiteral("playbackRoutes"));
+        scene.recordingRoutes = readRoutes(config, QStringLiteral("recordingRoutes"));
+
+        if (!scene.name.isEmpty()) {
+            scenes.append(scene);
+        }
+    }
+    config.endArray();
+
+    return scenes;
+}
+
+void Scene::saveAll(const QVector<Scene> &scenes)
+{
+    QSettings config;
+
+    // Or entries past the new end would linger
+    config.remove(QStringLiteral("scenes"));
+
+    config.beginWriteArray(QStringLiteral("scenes"), scenes.size());
+    for (int i = 0; i < scenes.size(); i++) {
+        const Scene &scene = scenes[i];
+        config.setArrayIndex(i);
+        config.setValue(QStringLiteral("name"), scene.name);
+        config.setValue(QStringLiteral("defaultSink"), scene.defaultSink);
+        config.setValue(QStringLiteral("defaultSource"), scene.defaultSource);
+        writeRoutes(config, QStringLiteral("cardProfiles"), scene.cardProfiles);
+        writeDevices(config, QStringLiteral("sinks"), scene.sinks);
+        writeDevices(config, QStringLiteral("sources"), scene.sources);
+        writeRoutes(config, QStringLiteral("playbackRoutes"), scene.playbackRoutes);
+        writeRoutes(config, QStringLiteral("recordingRoutes"), scene.recordingRoutes);
+    }
+    config.endArray();
+}
+
+SceneReader::SceneReader(pa_context *context, QObject *parent) :
+    QObject(parent)
+{
+    // Finishing needs them all, so nothing may complete before the last one
+    // has been started
+    m_outstanding = 1;
+
+    start(pa_context_get_server_info(context, &SceneReader::serverInfoCallback, this));
+    start(pa_context_get_card_info_list(context, &SceneReader::cardCallback, this));
+    start(pa_context_get_sink_info_list(context, &SceneReader::sinkCallback, this));
+    start(pa_context_get_source_info_list(context, &SceneReader::sourceCallback, this));
+    start(pa_context_get_sink_input_info_list(context, &SceneReader::sinkInputCallback, this));
+    start(pa_context_get_source_output_info_list(context, &SceneReader::sourceOutputCallback, this));
+
+    finishOne();
+}
+
+SceneReader::~SceneReader()
+{
+    for (pa_operation *o : m_operations) {
+        if (pa_operation_get_state(o) == PA_OPERATION_RUNNING) {
+            pa_operation_cancel(o);
+        }
+
+        pa_operation_unref(o);
+    }
+}
+
+void SceneReader::start(pa_operation *o)
+{
+    if (!o) {
+        show_error(tr("Reading the current setup failed").toUtf8().constData());
+        return;
+    }
+
+    m_operations.append(o);
+    m_outstanding++;
+}
+
+void SceneReader::finishOne()
+{
+    if (--m_outstanding > 0) {
+        return;
+    }
+
+    // Sinks and sources have all been seen by now. Streams of the same
+    // application may be spread out, the first one stands for all of them.
+    for (const Stream &stream : qAsConst(m_playbackStreams)) {
+        const QByteArray *sink = findValue(m_sinkNames, stream.device);
+        if (sink && !findValue(m_scene.playbackRoutes, stream.key)) {
+            m_scene.playbackRoutes.append(qMakePair(stream.key, *sink));
+        }
+    }
+    for (const Stream &stream : qAsConst(m_recordingStreams)) {
+        const QByteArray *source = findValue(m_sourceNames, stream.device);
+        if (source && !findValue(m_scene.recordingRoutes, stream.key)) {
+            m_scene.recordingRoutes.append(qMakePair(stream.key, *source));
+        }
+    }
+
+    Q_EMIT finished();
+    deleteLater();
+}
+
+void SceneReader::serverInfoCallback(pa_context *, const pa_server_info *i, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (i) {
+        that->m_scene.defaultSink = i->default_sink_name;
+        that->m_scene.defaultSource = i->default_source_name;
+    }
+
+    that->finishOne();
+}
+
+void SceneReader::cardCallback(pa_context *, const pa_card_info *i, int eol, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (eol) {
+        that->finishOne();
+        return;
+    }
+
+    if (i->active_profile) {
+        that->m_scene.cardProfiles.append(qMakePair(QByteArray(i->name), QByteArray(i->active_profile->name)));
+    }
+}
+
+static Scene::Device deviceFrom(const char *name, const char *port, const pa_cvolume &volume, int mute)
+{
+    Scene::Device device;
+    device.name = name;
+    device.port = port;
+    device.volume = volume;
+    device.mute = mute;
+    return device;
+}
+
+void SceneReader::sinkCallback(pa_context *, const pa_sink_info *i, int eol, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (eol) {
+        that->finishOne();
+        return;
+    }
+
+    that->m_scene.sinks.append(deviceFrom(i->name, i->active_port ? i->active_port->name : "", i->volume, i->mute));
+    that->m_sinkNames.append(qMakePair(i->index, QByteArray(i->name)));
+}
+
+void SceneReader::sourceCallback(pa_context *, const pa_source_info *i, int eol, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (eol) {
+        that->finishOne();
+        return;
+    }
+
+    that->m_scene.sources.append(deviceFrom(i->name, i->active_port ? i->active_port->name : "", i->volume, i->mute));
+    that->m_sourceNames.append(qMakePair(i->index, QByteArray(i->name)));
+}
+
+void SceneReader::sinkInputCallback(pa_context *, const pa_sink_input_info *i, int eol, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (eol) {
+        that->finishOne();
+        return;
+    }
+
+    const QByteArray key = utils::streamKey(Properties::decode(i->proplist));
+    if (!key.isEmpty()) {
+        that->m_playbackStreams.append({i->index, i->sink, key});
+    }
+}
+
+void SceneReader::sourceOutputCallback(pa_context *, const pa_source_output_info *i, int eol, void *userdata)
+{
+    SceneReader *that = static_cast<SceneReader*>(userdata);
+
+    if (eol) {
+        that->finishOne();
+        return;
+    }
+
+    const QByteArray key = utils::streamKey(Properties::decode(i->proplist));
+    if (!key.isEmpty()) {
+        that->m_recordingStreams.append({i->index, i->source, key});
+    }
+}
+
+static void addToBatch(OperationBatch *batch, pa_operation *o)
+{
+    if (!o) {
+        show_error(QObject::tr("Restoring the scene failed").toUtf8().constData());
+        return;
+    }
+
+    batch->add(o);
+    pa_operation_unref(o);
+}
+
+// The by-name setters, sink and source flavours have the same signatures
+struct DeviceSetters
+{
+    decltype(&pa_context_set_sink_port_by_name) setPort;
+    decltype(&pa_context_set_sink_volume_by_name) setVolume;
+    decltype(&pa_context_set_sink_mute_by_name) setMute;
+};
+
+static const DeviceSetters sinkSetters = {
+    &pa_context_set_sink_port_by_name,
+    &pa_context_set_sink_volume_by_name,
+    &pa_context_set_sink_mute_by_name,
+};
+
+static const DeviceSetters sourceSetters = {
+    &pa_context_set_source_port_by_name,
+    &pa_context_set_source_volume_by_name,
+    &pa_context_set_source_mute_by_name,
+};
+
+// Devices that only show up with new profiles can't be compared, they just
+// get everything
+static void restorePorts(const QVector<Scene::Device> &wanted, const QVector<Scene::Device> &current, bool profilesChanged,
+                         const DeviceSetters &setters, pa_context *context, OperationBatch *batch)
+{
+    for (const Scene::Device &device : wanted) {
+        const Scene::Device *now = findByName(current, device.name);
+        if (!now && !profilesChanged) {
+            continue;
+        }
+
+        if (!device.port.isEmpty() && (!now || now->port != device.port)) {
+            addToBatch(batch, setters.setPort(context, device.name.constData(), device.port.constData(), &OperationBatch::callback, batch));
+        }
+    }
+}
+
+// Only devices that were there all along, on the same port, are ramped,
+// anything else may not have the volume its widget shows
+static void restoreLevels(const QVector<Scene::Device> &wanted, const QVector<Scene::Device> &current, bool profilesChanged,
+                          const DeviceSetters &setters, pa_context *context, OperationBatch *batch,
+                          bool source, const SceneReader::RampFunction &ramp)
+{
+    for (const Scene::Device &device : wanted) {
+        const Scene::Device *now = findByName(current, device.name);
+        if (!now && !profilesChanged) {
+            continue;
+        }
+
+        // The channel count may have changed since, with another profile
+        pa_cvolume volume = device.volume;
+        if (now && now->volume.channels != volume.channels) {
+            volume = now->volume;
+            pa_cvolume_scale(&volume, pa_cvolume_max(&device.volume));
+        }
+
+        if (!now || !pa_cvolume_equal(&now->volume, &volume)) {
+            const bool canRamp = ramp && now && !profilesChanged && (device.port.isEmpty() || device.port == now->port);
+            if (!canRamp || !ramp(source, device.name, volume)) {
+                addToBatch(batch, setters.setVolume(context, device.name.constData(), &volume, &OperationBatch::callback, batch));
+            }
+        }
+
+        if (!now || now->mute != device.mute) {
+            addToBatch(batch, setters.setMute(context, device.name.constData(), device.mute, &OperationBatch::callback, batch));
+        }
+    }
+}
+
+void SceneReader::restore(const Scene &target, pa_context *context, OperationBatch *batch, const RampFunction &ramp) const
+{
+    // Profiles first, they decide which sinks and sources there are at all
+    bool profilesChanged = false;
+    for (const QPair<QByteArray, QByteArray> &card : target.cardProfiles) {
+        const QByteArray *profile = findValue(m_scene.cardProfiles, card.first);
+        if (profile && *profile != card.second) {
+            addToBatch(batch, pa_context_set_card_profile_by_name(context, card.first.constData(), card.second.constData(), &OperationBatch::callback, batch));
+            profilesChanged = true;
+        }
+    }
+
+    // Then ports, which may bring their own volumes along
+    restorePorts(target.sinks, m_scene.sinks, profilesChanged, sinkSetters, context, batch);
+    restorePorts(target.sources, m_scene.sources, profilesChanged, sourceSetters, context, batch);
+
+    restoreLevels(target.sinks, m_scene.sinks, profilesChanged, sinkSetters, context, batch, false, ramp);
+    restoreLevels(target.sources, m_scene.sources, profilesChanged, sourceSetters, context, batch, true, ramp);
+
+    if (!target.defaultSink.isEmpty() && target.defaultSink != m_scene.defaultSink) {
+        addToBatch(batch, pa_context_set_default_sink(context, target.defaultSink.constData(), &OperationBatch::callback, batch));
+    }
+
+    if (!target.defaultSource.isEmpty() && target.defaultSource != m_scene.defaultSource) {
+        addToBatch(batch, pa_context_set_default_source(context, target.defaultSource.constData(), &OperationBatch::callback, batch));
+    }
+
+    // Streams last, their devices may only just have appeared
+    for (const Stream &stream : m_playbackStreams) {
+        const QByteArray *device = findValue(target.playbackRoutes, stream.key);
+        const QByteArray *now = findValue(m_sinkNames, stream.device);
+        if (device && (!now || *now != *device)) {
+            addToBatch(batch, pa_context_move_sink_input_by_name(context, stream.index, device->constData(), &OperationBatch::callback, batch));
+        }
+    }
+
+    for (const Stream &stream : m_recordingStreams) {
+        const QByteArray *device = findValue(target.recordingRoutes, stream.key);
+        const QByteArray *now = findValue(m_sourceNames, stream.device);
+        if (device && (!now || *now != *device)) {
+            addToBatch(batch, pa_context_move_source_output_by_name(context, stream.index, device->constData(), &OperationBatch::callback, batch));
+        }
+    }
+}
@@ -0,0 +1,110 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QByteArray>
+#include <QObject>
+#include <QPair>
+#include <QString>
+#include <QVector>
+
+#include <pulse/context.h>
+#include <pulse/introspect.h>
+
+#include <functional>
+
+class OperationBatch;
+
+// Everything a mixer setup is made of, with objects named the way the
+// server names them, since indices don't survive a profile switch or a
+// restart. Streams go by their stream-restore id, or application name.
+struct Scene
+{
+    struct Device
+    {
+        QByteArray name;
+        QByteArray port;
+        pa_cvolume volume;
+        bool mute = false;
+    };
+
+    QString name;
+    QByteArray defaultSink;
+    QByteArray defaultSource;
+    // (card, profile) and (stream, device)
+    QVector<QPair<QByteArray, QByteArray>> cardProfiles;
+    QVector<Device> sinks;
+    QVector<Device> sources;
+    QVector<QPair<QByteArray, QByteArray>> playbackRoutes;
+    QVector<QPair<QByteArray, QByteArray>> recordingRoutes;
+
+    // In the application's QSettings, under "scenes"
+    static QVector<Scene> loadAll();
+    static void saveAll(const QVector<Scene> &scenes);
+};
+
+// Reads what the server has right now, with queries of its own so that
+// tabs not built yet or shown as compact lists don't matter. Deletes itself
+// after finished().
+class SceneReader : public QObject
+{
+    Q_OBJECT
+public:
+    explicit SceneReader(pa_context *context, QObject *parent = nullptr);
+    ~SceneReader() override;
+
+    const Scene &scene() const { return m_scene; }
+
+    // Takes over a device volume to ramp it instead, false if it can't
+    typedef std::function<bool(bool source, const QByteArray &name, const pa_cvolume &volume)> RampFunction;
+
+    // Sends what differs between target and what was read, profiles before
+    // ports before volumes, defaults and stream moves. One connection's
+    // commands are handled in order, so all of it can go out at once.
+    void restore(const Scene &target, pa_context *context, OperationBatch *batch, const RampFunction &ramp = RampFunction()) const;
+
+Q_SIGNALS:
+    void finished();
+
+private:
+    struct Stream
+    {
+        uint32_t index;
+        uint32_t device;
+        QByteArray key;
+    };
+
+    static void serverInfoCallback(pa_context *c, const pa_server_info *i, void *userdata);
+    static void cardCallback(pa_context *c, const pa_card_info *i, int eol, void *userdata);
+    static void sinkCallback(pa_context *c, const pa_sink_info *i, int eol, void *userdata);
+    static void sourceCallback(pa_context *c, const pa_source_info *i, int eol, void *userdata);
+    static void sinkInputCallback(pa_context *c, const pa_sink_input_info *i, int eol, void *userdata);
+    static void sourceOutputCallback(pa_context *c, const pa_source_output_info *i, int eol, void *userdata);
+
+    void start(pa_operation *o);
+    void finishOne();
+
+    Scene m_scene;
+    QVector<QPair<uint32_t, QByteArray>> m_sinkNames;
+    QVector<QPair<uint32_t, QByteArray>> m_sourceNames;
+    QVector<Stream> m_playbackStreams;
+    QVector<Stream> m_recordingStreams;
+    QVector<pa_operation *> m_operations;
+    int m_outstanding = 0;
+};
@@ -0,0 +1,134 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "searchindex.h"
+
+static const QChar FIELD_SEPARATOR = QLatin1Char('\n');
+
+QSet<quint64> SearchIndex::trigrams(const QString &text)
+{
+    QSet<quint64> result;
+
+    for (int i = 0; i + 2 < text.size(); i++) {
+        const ushort a = text.at(i).unicode();
+        const ushort b = text.at(i + 1).unicode();
+        const ushort c = text.at(i + 2).unicode();
+
+        if (a == FIELD_SEPARATOR || b == FIELD_SEPARATOR || c == FIELD_SEPARATOR) {
+            continue;
+        }
+
+        result.insert((quint64(a) << 32) | (quint64(b) << 16) | c);
+    }
+
+    return result;
+}
+
+bool SearchIndex::setDocument(Key key, const QStringList &fields)
+{
+    const QString text = fields.join(FIELD_SEPARATOR).toCaseFolded();
+
+    auto it = m_documents.find(key);
+    if (it != m_documents.end()) {
+        if (it.value() == text) {
+            return false;
+        }
+        removeDocument(key);
+    }
+
+    m_documents.insert(key, text);
+    for (quint64 trigram : trigrams(text)) {
+        m_postings[trigram].insert(key);
+    }
+
+    return true;
+}
+
+void SearchIndex::removeDocument(Key key)
+{
+    auto it = m_documents.find(key);
+    if (it == m_documents.end()) {
+        return;
+    }
+
+    for (quint64 trigram : trigrams(it.value())) {
+        auto posting = m_postings.find(trigram);
+        if (posting == m_postings.end()) {
+            continue;
+        }
+
+        posting.value().remove(key);
+        if (posting.value().isEmpty()) {
+            m_postings.erase(posting);
+        }
+    }
+
+    m_documents.erase(it);
+}
+
+void SearchIndex::clear()
+{
+    m_documents.clear();
+    m_postings.clear();
+}
+
+QSet<SearchIndex::Key> SearchIndex::match(const QString &query) const
+{
+    const QString folded = query.toCaseFolded();
+    QSet<Key> result;
+
+    // Too short to have a trigram, and likely to match most things anyway
+    if (folded.size() < 3) {
+        for (auto it = m_documents.constBegin(); it != m_documents.constEnd(); ++it) {
+            if (it.value().contains(folded)) {
+                result.insert(it.key());
+            }
+        }
+        return result;
+    }
+
+    // Only the documents having the query's rarest trigram can match
+    const QSet<Key> *candidates = nullptr;
+    for (quint64 trigram : trigrams(folded)) {
+        auto posting = m_postings.constFind(trigram);
+        if (posting == m_postings.constEnd()) {
+            return result;
+        }
+
+        if (!candidates || posting.value().size() < candidates->size()) {
+            candidates = &posting.value();
+        }
+    }
+
+    if (!candidates) {
+        return result;
+    }
+
+    for (Key key : *candidates) {
+        if (m_documents.value(key).contains(folded)) {
+            result.insert(key);
+        }
+    }
+
+    return result;
+}
+
+bool SearchIndex::matches(Key key, const QString &query) const
+{
+    return m_documents.value(key).contains(query.toCaseFolded());
+}
@@ -0,0 +1,55 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QHash>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+// Trigram index over a few strings per widget, so filtering hundreds of
+// streams only looks at the ones sharing the query's rarest trigram
+// instead of searching through every widget's text on each keystroke.
+class SearchIndex
+{
+public:
+    typedef quint64 Key;
+
+    // Widgets are only unique per tab
+    static Key key(int group, uint32_t index) { return (Key(group) << 32) | index; }
+    static int group(Key key) { return int(key >> 32); }
+    static uint32_t index(Key key) { return uint32_t(key); }
+
+    // Returns false when the document was already indexed with these fields
+    bool setDocument(Key key, const QStringList &fields);
+    void removeDocument(Key key);
+    void clear();
+
+    // Documents that contain query in one of their fields, ignoring case
+    QSet<Key> match(const QString &query) const;
+    bool matches(Key key, const QString &query) const;
+
+private:
+    static QSet<quint64> trigrams(const QString &text);
+
+    // The fields are folded to lower case and joined by newlines, which no
+    // trigram spans so a match can't run from one field into the next
+    QHash<Key, QString> m_documents;
+    QHash<quint64, QSet<Key>> m_postings;
+};
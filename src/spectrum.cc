@@ -0,0 +1,173 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "spectrum.h"
+
+#include <algorithm>
+#include <cmath>
+
+// 4096 points gives ~12Hz resolution at 48kHz, enough to tell mains hum
+// harmonics apart, and a new spectrum every 21ms
+constexpr size_t FFT_SIZE = 4096;
+constexpr size_t HOP_SIZE = FFT_SIZE / 4;
+constexpr double LOWEST_FREQUENCY = 20.;
+constexpr double HIGHEST_FREQUENCY = 20000.;
+constexpr float SILENCE = -120.f;
+
+void SpectrumAnalyzer::configure(unsigned rate, unsigned channels, size_t bands)
+{
+    m_rate = rate;
+    m_channels = channels;
+
+    m_window.resize(FFT_SIZE);
+    double windowSum = 0.;
+    for (size_t i = 0; i < FFT_SIZE; i++) {
+        m_window[i] = float(0.5 - 0.5 * std::cos(2. * M_PI * i / FFT_SIZE));
+        windowSum += m_window[i];
+    }
+
+    // Scale so a full scale sine reads 0dB, averaging the channels on the way
+    const float scale = float(2. / windowSum / std::max(1u, channels));
+    for (float &w : m_window) {
+        w *= scale;
+    }
+
+    m_history.assign(FFT_SIZE, 0.f);
+    m_historyPosition = 0;
+    m_sinceTransform = 0;
+
+    m_fft.resize(FFT_SIZE);
+    m_power.resize(FFT_SIZE / 2 + 1);
+
+    m_twiddles.resize(FFT_SIZE / 2);
+    for (size_t i = 0; i < FFT_SIZE / 2; i++) {
+        m_twiddles[i] = std::polar(1.f, float(-2. * M_PI * i / FFT_SIZE));
+    }
+
+    unsigned bits = 0;
+    while ((size_t(1) << bits) < FFT_SIZE) {
+        bits++;
+    }
+
+    m_bitReverse.resize(FFT_SIZE);
+    for (unsigned i = 0; i < FFT_SIZE; i++) {
+        unsigned reversed = 0;
+        for (unsigned b = 0; b < bits; b++) {
+            reversed |= ((i >> b) & 1) << (bits - 1 - b);
+        }
+        m_bitReverse[i] = reversed;
+    }
+
+    m_lowest = LOWEST_FREQUENCY;
+    m_highest = std::min(HIGHEST_FREQUENCY, rate / 2.);
+    m_bands.assign(bands, SILENCE);
+    m_bandBins.resize(bands + 1);
+
+    const double binWidth = double(rate) / FFT_SIZE;
+    for (size_t band = 0; band <= bands; band++) {
+        m_bandBins[band] = std::min(size_t(std::lround(bandFrequency(band) / binWidth)), FFT_SIZE / 2);
+    }
+}
+
+double SpectrumAnalyzer::bandFrequency(size_t band) const
+{
+    if (m_bands.empty()) {
+        return m_lowest;
+    }
+
+    return m_lowest * std::pow(m_highest / m_lowest, double(band) / m_bands.size());
+}
+
+bool SpectrumAnalyzer::process(const float *samples, size_t frames)
+{
+    if (m_channels == 0) {
+        return false;
+    }
+
+    bool updated = false;
+
+    for (size_t i = 0; i < frames; i++) {
+        const float *frame = samples + i * m_channels;
+
+        float sum = 0.f;
+        for (unsigned c = 0; c < m_channels; c++) {
+            sum += frame[c];
+        }
+
+        m_history[m_historyPosition] = sum;
+        m_historyPosition = (m_historyPosition + 1) % FFT_SIZE;
+
+        if (++m_sinceTransform == HOP_SIZE) {
+            m_sinceTransform = 0;
+            transform();
+            updated = true;
+        }
+    }
+
+    if (updated) {
+        updateBands();
+    }
+
+    return updated;
+}
+
+void SpectrumAnalyzer::transform()
+{
+    // Oldest sample first, windowed, straight into bit reversed order
+    for (size_t i = 0; i < FFT_SIZE; i++) {
+        const float value = m_history[(m_historyPosition + i) % FFT_SIZE] * m_window[i];
+        m_fft[m_bitReverse[i]] = std::complex<float>(value, 0.f);
+    }
+
+    for (size_t size = 2; size <= FFT_SIZE; size <<= 1) {
+        const size_t half = size / 2;
+        const size_t step = FFT_SIZE / size;
+
+        for (size_t start = 0; start < FFT_SIZE; start += size) {
+            for (size_t k = 0; k < half; k++) {
+                const std::complex<float> t = m_twiddles[k * step] * m_fft[start + k + half];
+                m_fft[start + k + half] = m_fft[start + k] - t;
+                m_fft[start + k] += t;
+            }
+        }
+    }
+
+    for (size_t i = 0; i <= FFT_SIZE / 2; i++) {
+        m_power[i] = std::norm(m_fft[i]);
+    }
+}
+
+void SpectrumAnalyzer::updateBands()
+{
+    for (size_t band = 0; band < m_bands.size(); band++) {
+        size_t first = m_bandBins[band];
+        size_t last = m_bandBins[band + 1];
+
+        // Low bands can be narrower than a bin, they show the bin they're in
+        if (last <= first) {
+            last = first + 1;
+        }
+        last = std::min(last, m_power.size());
+
+        float power = 0.f;
+        for (size_t bin = first; bin < last; bin++) {
+            power = std::max(power, m_power[bin]);
+        }
+
+        m_bands[band] = power > 0.f ? std::max(SILENCE, 10.f * std::log10(power)) : SILENCE;
+    }
+}
@@ -0,0 +1,62 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <complex>
+#include <cstddef>
+#include <vector>
+
+// Hann windowed FFT of the downmixed input, summed into log spaced bands.
+// Not thread safe, meant to live on one worker.
+class SpectrumAnalyzer
+{
+public:
+    void configure(unsigned rate, unsigned channels, size_t bands);
+
+    // Interleaved samples, returns true when a new spectrum is ready
+    bool process(const float *samples, size_t frames);
+
+    // Level of each band in dBFS, lowest frequency first
+    const std::vector<float> &bands() const { return m_bands; }
+
+    // Lower edge of a band in Hz, band == bands().size() gives the top edge
+    double bandFrequency(size_t band) const;
+
+private:
+    void transform();
+    void updateBands();
+
+    unsigned m_rate = 0;
+    unsigned m_channels = 0;
+
+    std::vector<float> m_window;
+    std::vector<float> m_history;
+    size_t m_historyPosition = 0;
+    size_t m_sinceTransform = 0;
+
+    std::vector<std::complex<float>> m_fft;
+    std::vector<std::complex<float>> m_twiddles;
+    std::vector<unsigned> m_bitReverse;
+    std::vector<float> m_power;
+
+    // First FFT bin of each band, plus one past the last band
+    std::vector<size_t> m_bandBins;
+    std::vector<float> m_bands;
+    double m_lowest = 0.;
+    double m_highest = 0.;
+};
@@ -0,0 +1,56 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "spectrummeter.h"
+
+constexpr size_t BAND_COUNT = 64;
+
+SpectrumMeter::SpectrumMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent) :
+    MonitorTap(parent)
+{
+    start(tr("Spectrum analyzer"), source, stream, map);
+}
+
+SpectrumMeter::~SpectrumMeter()
+{
+    stop();
+}
+
+void SpectrumMeter::configure(const pa_sample_spec &spec, const pa_channel_map &)
+{
+    m_analyzer.configure(spec.rate, spec.channels, BAND_COUNT);
+}
+
+bool SpectrumMeter::analyze(const float *samples, size_t frames)
+{
+    return m_analyzer.process(samples, frames);
+}
+
+void SpectrumMeter::publish()
+{
+    const std::vector<float> &bands = m_analyzer.bands();
+    const QVector<float> copy(bands.begin(), bands.end());
+    const double lowest = m_analyzer.bandFrequency(0);
+    const double highest = m_analyzer.bandFrequency(bands.size());
+
+    QMetaObject::invokeMethod(this, [this, copy, lowest, highest] {
+        m_bands = copy;
+        m_lowest = lowest;
+        m_highest = highest;
+        Q_EMIT spectrumChanged();
+    });
+}
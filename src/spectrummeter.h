@@ -0,0 +1,54 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "monitortap.h"
+#include "spectrum.h"
+
+#include <QVector>
+
+// Spectrum of a source or sink input, see SpectrumAnalyzer
+class SpectrumMeter : public MonitorTap
+{
+    Q_OBJECT
+
+public:
+    SpectrumMeter(uint32_t source, uint32_t stream, const pa_channel_map &map, QObject *parent = nullptr);
+    ~SpectrumMeter() override;
+
+    // dBFS per band, empty until the first spectrum arrives
+    const QVector<float> &bands() const { return m_bands; }
+    double lowestFrequency() const { return m_lowest; }
+    double highestFrequency() const { return m_highest; }
+
+Q_SIGNALS:
+    void spectrumChanged();
+
+protected:
+    void configure(const pa_sample_spec &spec, const pa_channel_map &map) override;
+    bool analyze(const float *samples, size_t frames) override;
+    void publish() override;
+
+private:
+    // Worker thread only
+    SpectrumAnalyzer m_analyzer;
+
+    QVector<float> m_bands;
+    double m_lowest = 0.;
+    double m_highest = 0.;
+};
@@ -0,0 +1,151 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "spectrumview.h"
+
+#include <QPainter>
+
+#include <cmath>
+
+constexpr double DECAY_MSECS = 300.;
+constexpr float FLOOR_DB = -90.f;
+
+// 0 is the floor, 1 is full scale
+static float normalize(float decibel)
+{
+    return qBound(0.f, 1.f - decibel / FLOOR_DB, 1.f);
+}
+
+SpectrumView::SpectrumView(QWidget *parent) :
+    QWidget(parent)
+{
+    setSizePolicy(QSizePolicy::Expanding, QSizePolicy::Fixed);
+    setAttribute(Qt::WA_OpaquePaintEvent);
+}
+
+SpectrumView::~SpectrumView()
+{
+    FrameTicker::instance()->unschedule(this);
+}
+
+QSize SpectrumView::sizeHint() const
+{
+    return QSize(200, 6 * fontMetrics().height());
+}
+
+QSize SpectrumView::minimumSizeHint() const
+{
+    return QSize(100, 6 * fontMetrics().height());
+}
+
+void SpectrumView::setBands(const QVector<float> &bands, double lowest, double highest)
+{
+    const qint64 now = FrameTicker::instance()->now();
+
+    if (m_bars.size() != bands.size()) {
+        m_bars.fill(Bar(), bands.size());
+        m_painted.fill(0.f, bands.size());
+    }
+
+    m_lowest = lowest;
+    m_highest = highest;
+
+    for (int i = 0; i < bands.size(); i++) {
+        Bar &bar = m_bars[i];
+        const float value = normalize(bands[i]);
+
+        bar.start = qMax(value, levelAt(bar, now));
+        bar.target = value;
+        bar.startTime = now;
+    }
+
+    if (isVisible()) {
+        FrameTicker::instance()->schedule(this);
+    }
+}
+
+float SpectrumView::levelAt(const Bar &bar, qint64 msecs) const
+{
+    const double elapsed = msecs - bar.startTime;
+    return float(bar.target + (bar.start - bar.target) * std::exp(-elapsed / DECAY_MSECS));
+}
+
+int SpectrumView::xForFrequency(double frequency) const
+{
+    return qRound(width() * std::log(frequency / m_lowest) / std::log(m_highest / m_lowest));
+}
+
+bool SpectrumView::advanceFrame(qint64 msecs)
+{
+    if (!isVisible()) {
+        return false;
+    }
+
+    bool moving = false;
+
+    for (int i = 0; i < m_bars.size(); i++) {
+        m_painted[i] = levelAt(m_bars[i], msecs);
+        moving |= m_painted[i] - m_bars[i].target > 0.002f;
+    }
+
+    update();
+
+    return moving;
+}
+
+void SpectrumView::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+
+    painter.fillRect(rect(), palette().color(QPalette::Base));
+
+    const int textHeight = fontMetrics().height();
+    const QRect graph = rect().adjusted(0, 0, 0, -textHeight);
+
+    // Decades plus mains frequencies, the usual suspects for hum
+    static const double marks[] = { 50., 60., 100., 1000., 10000. };
+
+    painter.setPen(palette().color(QPalette::Mid));
+    for (double frequency : marks) {
+        if (frequency < m_lowest || frequency > m_highest) {
+            continue;
+        }
+
+        const int x = xForFrequency(frequency);
+        painter.drawLine(x, graph.top(), x, graph.bottom());
+
+        if (frequency >= 100.) {
+            const QString label = frequency >= 1000. ? tr("%1k").arg(frequency / 1000.) : QString::number(frequency);
+            painter.drawText(x + 2, rect().bottom() - fontMetrics().descent(), label);
+        }
+    }
+
+    const QColor barColor = palette().color(QPalette::Highlight);
+    const int count = m_painted.size();
+
+    for (int i = 0; i < count; i++) {
+        const int left = i * graph.width() / count;
+        const int right = (i + 1) * graph.width() / count;
+        const int height = qRound(m_painted[i] * graph.height());
+
+        // One pixel gap between bars as long as they're wide enough
+        painter.fillRect(left, graph.bottom() + 1 - height, qMax(1, right - left - 1), height, barColor);
+    }
+
+    painter.setPen(palette().color(QPalette::Mid));
+    painter.drawRect(rect().adjusted(0, 0, -1, -1));
+}
@@ -0,0 +1,60 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "frameticker.h"
+
+#include <QWidget>
+#include <QVector>
+
+// Log frequency bar graph, bars jump up and fall off like PeakMeter
+class SpectrumView : public QWidget, public FrameTicker::Client
+{
+    Q_OBJECT
+
+public:
+    explicit SpectrumView(QWidget *parent = nullptr);
+    ~SpectrumView() override;
+
+    // dBFS per band, log spaced between lowest and highest Hz
+    void setBands(const QVector<float> &bands, double lowest, double highest);
+
+    bool advanceFrame(qint64 msecs) override;
+
+    QSize sizeHint() const override;
+    QSize minimumSizeHint() const override;
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    struct Bar
+    {
+        float start = 0.f;
+        float target = 0.f;
+        qint64 startTime = 0;
+    };
+
+    float levelAt(const Bar &bar, qint64 msecs) const;
+    int xForFrequency(double frequency) const;
+
+    QVector<Bar> m_bars;
+    QVector<float> m_painted;
+    double m_lowest = 20.;
+    double m_highest = 20000.;
+};
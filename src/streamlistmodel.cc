@@ -0,0 +1,333 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "streamlistmodel.h"
+#include "operationbatch.h"
+#include "volumewriter.h"
+
+StreamListModel::StreamListModel(Kind kind, QObject *parent) :
+    QAbstractListModel(parent),
+    m_kind(kind)
+{
+}
+
+StreamListModel::~StreamListModel()
+{
+    qDeleteAll(m_volumeWriters);
+}
+
+bool StreamListModel::updateStream(const Stream &stream)
+{
+    const auto it = m_rows.constFind(stream.index);
+
+    if (it != m_rows.constEnd()) {
+        Stream &row = m_streams[*it];
+        const pa_cvolume volume = row.volume;
+        row = stream;
+
+        // Ours is newer than what the server had when it sent this
+        const VolumeWriter *writer = m_volumeWriters.value(stream.index);
+        if (writer && writer->isBusy()) {
+            row.volume = volume;
+        }
+
+        const QModelIndex changed = index(*it);
+        Q_EMIT dataChanged(changed, changed);
+        return false;
+    }
+
+    const int row = m_streams.size();
+
+    beginInsertRows(QModelIndex(), row, row);
+    m_streams.append(stream);
+    m_rows.insert(stream.index, row);
+    endInsertRows();
+
+    return true;
+}
+
+bool StreamListModel::removeStream(uint32_t index)
+{
+    const auto it = m_rows.find(index);
+    if (it == m_rows.end()) {
+        return false;
+    }
+
+    const int row = *it;
+
+    delete m_volumeWriters.take(index);
+
+    beginRemoveRows(QModelIndex(), row, row);
+    m_streams.remove(row);
+    m_rows.erase(it);
+
+    // Everything after it moved up by one
+    for (int i = row; i < m_streams.size(); i++) {
+        m_rows[m_streams[i].index] = i;
+    }
+    endRemoveRows();
+
+    return true;
+}
+
+void StreamListModel::clear()
+{
+    beginResetModel();
+    qDeleteAll(m_volumeWriters);
+    m_volumeWriters.clear();
+    m_streams.clear();
+    m_rows.clear();
+    endResetModel();
+}
+
+void StreamListModel::setClientName(uint32_t client, const QString &name)
+{
+    m_clientNames.insert(client, name);
+
+    for (int row = 0; row < m_streams.size(); row++) {
+        if (m_streams[row].client == client) {
+            const QModelIndex changed = index(row);
+            Q_EMIT dataChanged(changed, changed, { ClientNameRole, Qt::ToolTipRole });
+        }
+    }
+}
+
+void StreamListModel::removeClient(uint32_t client)
+{
+    m_clientNames.remove(client);
+}
+
+int StreamListModel::rowCount(const QModelIndex &parent) const
+{
+    return parent.isValid() ? 0 : m_streams.size();
+}
+
+Qt::ItemFlags StreamListModel::flags(const QModelIndex &index) const
+{
+    return QAbstractListModel::flags(index) | Qt::ItemIsEditable;
+}
+
+QVariant StreamListModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= m_streams.size()) {
+        return QVariant();
+    }
+
+    const Stream &stream = m_streams.at(index.row());
+    const QString clientName = m_clientNames.value(stream.client);
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return stream.name;
+    case Qt::ToolTipRole:
+        return clientName.isEmpty() ? stream.name : QStringLiteral("%1: %2").arg(clientName, stream.name);
+    case Qt::DecorationRole:
+        return stream.icon;
+    case ClientNameRole:
+        return clientName;
+    case DeviceRole:
+        return stream.deviceName;
+    case VolumeRole:
+        return int(pa_cvolume_max(&stream.volume));
+    case MuteRole:
+        return stream.mute;
+    case TypeRole:
+        return stream.type;
+    default:
+        return QVariant();
+    }
+}
+
+bool StreamListModel::setData(const QModelIndex &index, const QVariant &value, int role)
+{
+    if (!index.isValid() || index.row() >= m_streams.size()) {
+        return false;
+    }
+
+    Stream &stream = m_streams[index.row()];
+
+    switch (role) {
+    case VolumeRole: {
+        const pa_volume_t volume = pa_volume_t(value.toUInt());
+        if (volume == pa_cvolume_max(&stream.volume)) {
+            return false;
+        }
+
+        // Keeps the balance between the channels
+        const pa_cvolume before = stream.volume;
+        pa_cvolume_scale(&stream.volume, volume);
+        volumeWriter(stream.index)->write();
+
+        Q_EMIT dataChanged(index, index, { role });
+        Q_EMIT volumeEdited(stream.index, before);
+        return true;
+    }
+    case MuteRole:
+        if (value.toBool() == stream.mute) {
+            return false;
+        }
+
+        stream.mute = value.toBool();
+        sendMute(stream);
+
+        Q_EMIT dataChanged(index, index, { role });
+        Q_EMIT muteEdited(stream.index);
+        return true;
+    default:
+        return false;
+    }
+}
+
+QVector<uint32_t> StreamListModel::findStreams(const QByteArray &key, uint32_t index) const
+{
+    const int row = rowForIndex(index);
+    if (row >= 0 && m_streams.at(row).key == key) {
+        return { index };
+    }
+
+    QVector<uint32_t> found;
+    for (const Stream &stream : m_streams) {
+        if (stream.key == key) {
+            found.append(stream.index);
+        }
+    }
+
+    return found;
+}
+
+void StreamListModel::setVolume(uint32_t index, const pa_cvolume &volume)
+{
+    const int row = rowForIndex(index);
+    if (row < 0) {
+        return;
+    }
+
+    Stream &stream = m_streams[row];
+    if (stream.volume.channels == volume.channels) {
+        stream.volume = volume;
+    } else {
+        pa_cvolume_scale(&stream.volume, pa_cvolume_max(&volume));
+    }
+
+    volumeWriter(index)->write();
+
+    const QModelIndex changed = this->index(row);
+    Q_EMIT dataChanged(changed, changed, { VolumeRole });
+}
+
+void StreamListModel::setMute(uint32_t index, bool mute, OperationBatch *batch)
+{
+    const int row = rowForIndex(index);
+    if (row < 0 || m_streams[row].mute == mute) {
+        return;
+    }
+
+    Stream &stream = m_streams[row];
+    stream.mute = mute;
+    sendMute(stream, batch);
+
+    const QModelIndex changed = this->index(row);
+    Q_EMIT dataChanged(changed, changed, { MuteRole });
+}
+
+void StreamListModel::moveTo(uint32_t index, uint32_t device, OperationBatch *batch)
+{
+    const int row = rowForIndex(index);
+    if (row < 0 || m_streams[row].device == device) {
+        return;
+    }
+
+    pa_operation *o;
+
+    if (m_kind == Playback) {
+        if (!(o = pa_context_move_sink_input_by_index(get_context(), index, device, batch ? &OperationBatch::callback : nullptr, batch))) {
+            show_error(tr("pa_context_move_sink_input_by_index() failed").toUtf8().constData());
+            return;
+        }
+    } else {
+        if (!(o = pa_context_move_source_output_by_index(get_context(), index, device, batch ? &OperationBatch::callback : nullptr, batch))) {
+            show_error(tr("pa_context_move_source_output_by_index() failed").toUtf8().constData());
+            return;
+        }
+    }
+
+    if (batch) {
+        batch->add(o);
+    }
+    pa_operation_unref(o);
+}
+
+VolumeWriter *StreamListModel::volumeWriter(uint32_t index)
+{
+    VolumeWriter *&writer = m_volumeWriters[index];
+
+    if (!writer) {
+        writer = new VolumeWriter([this, index]() { sendVolume(index); });
+    }
+
+    return writer;
+}
+
+// The newest volume of the row, whenever the writer gets to it
+void StreamListModel::sendVolume(uint32_t index)
+{
+    const int row = rowForIndex(index);
+    VolumeWriter *writer = m_volumeWriters.value(index);
+    if (row < 0 || !writer) {
+        return;
+    }
+
+    const Stream &stream = m_streams.at(row);
+    pa_operation *o;
+
+    if (m_kind == Playback) {
+        if (!(o = pa_context_set_sink_input_volume(get_context(), stream.index, &stream.volume, &VolumeWriter::callback, writer))) {
+            show_error(tr("pa_context_set_sink_input_volume() failed").toUtf8().constData());
+            return;
+        }
+    } else {
+        if (!(o = pa_context_set_source_output_volume(get_context(), stream.index, &stream.volume, &VolumeWriter::callback, writer))) {
+            show_error(tr("pa_context_set_source_output_volume() failed").toUtf8().constData());
+            return;
+        }
+    }
+
+    writer->track(o);
+    pa_operation_unref(o);
+}
+
+void StreamListModel::sendMute(const Stream &stream, OperationBatch *batch)
+{
+    pa_operation *o;
+
+    if (m_kind == Playback) {
+        if (!(o = pa_context_set_sink_input_mute(get_context(), stream.index, stream.mute, batch ? &OperationBatch::callback : nullptr, batch))) {
+            show_error(tr("pa_context_set_sink_input_mute() failed").toUtf8().constData());
+            return;
+        }
+    } else {
+        if (!(o = pa_context_set_source_output_mute(get_context(), stream.index, stream.mute, batch ? &OperationBatch::callback : nullptr, batch))) {
+            show_error(tr("pa_context_set_source_output_mute() failed").toUtf8().constData());
+            return;
+        }
+    }
+
+    if (batch) {
+        batch->add(o);
+    }
+    pa_operation_unref(o);
+}
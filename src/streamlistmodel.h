@@ -0,0 +1,112 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include "pavucontrol.h"
+
+#include <QAbstractListModel>
+#include <QHash>
+#include <QIcon>
+#include <QVector>
+
+class OperationBatch;
+class VolumeWriter;
+
+// Sink inputs or source outputs as plain rows, for the compact lists that
+// paint streams on demand instead of keeping a widget around for each.
+class StreamListModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Kind {
+        Playback,
+        Recording,
+    };
+
+    enum Roles {
+        ClientNameRole = Qt::UserRole + 1,
+        DeviceRole,
+        VolumeRole,     // int, loudest channel, writable
+        MuteRole,       // bool, writable
+        TypeRole,       // PlaybackType or RecordingType
+    };
+
+    struct Stream
+    {
+        uint32_t index = PA_INVALID_INDEX;
+        uint32_t client = PA_INVALID_INDEX;
+        uint32_t device = PA_INVALID_INDEX;
+        int type = 0;
+        QByteArray key;         // utils::streamKey(), for the journal
+        QString name;
+        QString deviceName;
+        QIcon icon;
+        pa_cvolume volume;
+        bool mute = false;
+    };
+
+    explicit StreamListModel(Kind kind, QObject *parent = nullptr);
+    ~StreamListModel() override;
+
+    // Adds the stream or updates the existing row for its index, returns
+    // true when the row is new
+    bool updateStream(const Stream &stream);
+    bool removeStream(uint32_t index);
+    void clear();
+
+    // Client names are shared by all streams of a client and arrive separately
+    void setClientName(uint32_t client, const QString &name);
+    void removeClient(uint32_t client);
+
+    const Stream &stream(int row) const { return m_streams.at(row); }
+    int rowForIndex(uint32_t index) const { return m_rows.value(index, -1); }
+
+    // The stream with index while it still has key, else all that have it
+    QVector<uint32_t> findStreams(const QByteArray &key, uint32_t index) const;
+
+    // For undo and redo, these don't count as edits. A volume with another
+    // channel count only carries its level over.
+    void setVolume(uint32_t index, const pa_cvolume &volume);
+    void setMute(uint32_t index, bool mute, OperationBatch *batch = nullptr);
+    void moveTo(uint32_t index, uint32_t device, OperationBatch *batch = nullptr);
+
+    // Created on a row's first volume write, the same one-write-in-flight
+    // pipeline as the stream widgets have
+    VolumeWriter *volumeWriter(uint32_t index);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role) const override;
+    bool setData(const QModelIndex &index, const QVariant &value, int role) override;
+    Qt::ItemFlags flags(const QModelIndex &index) const override;
+
+Q_SIGNALS:
+    // The user changed a row through setData(), for the journal
+    void volumeEdited(uint32_t index, const pa_cvolume &before);
+    void muteEdited(uint32_t index);
+
+private:
+    void sendVolume(uint32_t index);
+    void sendMute(const Stream &stream, OperationBatch *batch = nullptr);
+
+    Kind m_kind;
+    QVector<Stream> m_streams;
+    QHash<uint32_t, int> m_rows;
+    QHash<uint32_t, QString> m_clientNames;
+    QHash<uint32_t, VolumeWriter *> m_volumeWriters;
+};
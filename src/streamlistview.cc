@@ -0,0 +1,236 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#include "streamlistview.h"
+#include "streamlistmodel.h"
+
+#include <QApplication>
+#include <QHBoxLayout>
+#include <QPainter>
+#include <QSlider>
+#include <QStyledItemDelegate>
+#include <QToolButton>
+
+constexpr int MARGIN = 4;
+constexpr int ICON_SIZE = 32;
+constexpr int VOLUME_BAR_HEIGHT = 4;
+
+class StreamRowEditor : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit StreamRowEditor(QWidget *parent) :
+        QWidget(parent)
+    {
+        setAutoFillBackground(true);
+
+        QHBoxLayout *layout = new QHBoxLayout(this);
+        layout->setContentsMargins(0, 0, 0, 0);
+
+        slider = new QSlider(Qt::Horizontal);
+        slider->setRange(PA_VOLUME_MUTED, PA_VOLUME_UI_MAX);
+        slider->setPageStep(PA_VOLUME_NORM / 20);
+        layout->addWidget(slider);
+
+        muteButton = new QToolButton;
+        muteButton->setToolTip(tr("Mute audio"));
+        muteButton->setCheckable(true);
+        muteButton->setIcon(QIcon::fromTheme("audio-volume-muted"));
+        layout->addWidget(muteButton);
+
+        connect(slider, &QSlider::valueChanged, this, &StreamRowEditor::edited);
+        connect(muteButton, &QToolButton::toggled, this, &StreamRowEditor::edited);
+    }
+
+    QSlider *slider;
+    QToolButton *muteButton;
+
+Q_SIGNALS:
+    void edited();
+};
+
+class StreamDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    using QStyledItemDelegate::QStyledItemDelegate;
+
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const override
+    {
+        const int text = option.fontMetrics.height();
+        return QSize(ICON_SIZE + 10 * text, qMax(ICON_SIZE, 2 * text + MARGIN) + 2 * MARGIN);
+    }
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option, const QModelIndex &index) const override
+    {
+        QStyleOptionViewItem opt = option;
+        initStyleOption(&opt, index);
+
+        // Background, selection and hover from the style, the rest is ours
+        opt.text.clear();
+        opt.icon = QIcon();
+        QStyle *style = opt.widget ? opt.widget->style() : QApplication::style();
+        style->drawControl(QStyle::CE_ItemViewItem, &opt, painter, opt.widget);
+
+        const bool muted = index.data(StreamListModel::MuteRole).toBool();
+        const QPalette::ColorGroup group = muted ? QPalette::Disabled : QPalette::Normal;
+        const QRect content = option.rect.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN);
+
+        const QIcon icon = index.data(Qt::DecorationRole).value<QIcon>();
+        icon.paint(painter, QRect(content.x(), content.y(), ICON_SIZE, ICON_SIZE), Qt::AlignCenter,
+                   muted ? QIcon::Disabled : QIcon::Normal);
+
+        const QRect text = content.adjusted(ICON_SIZE + MARGIN, 0, 0, 0);
+        const QRect titleLine(text.x(), text.y(), text.width(), option.fontMetrics.height());
+
+        painter->save();
+        painter->setPen(option.palette.color(group, QPalette::Text));
+
+        // Device on the right, the title gets whatever is left
+        const QString device = option.fontMetrics.elidedText(index.data(StreamListModel::DeviceRole).toString(), Qt::ElideRight, text.width() / 3);
+        painter->drawText(titleLine, Qt::AlignRight | Qt::AlignVCenter, device);
+
+        const int titleWidth = text.width() - option.fontMetrics.boundingRect(device).width() - 2 * MARGIN;
+        QString title = index.data(Qt::DisplayRole).toString();
+        const QString client = index.data(StreamListModel::ClientNameRole).toString();
+        if (!client.isEmpty()) {
+            title = QStringLiteral("%1: %2").arg(client, title);
+        }
+
+        QFont bold = option.font;
+        bold.setBold(true);
+        painter->setFont(bold);
+        painter->drawText(titleLine.adjusted(0, 0, -(text.width() - titleWidth), 0), Qt::AlignLeft | Qt::AlignVCenter,
+                          QFontMetrics(bold).elidedText(title, Qt::ElideRight, titleWidth));
+        painter->setFont(option.font);
+
+        // Volume as a thin bar plus percentage, the editor covers this line
+        const QRect volumeLine = volumeRect(option);
+        const int volume = index.data(StreamListModel::VolumeRole).toInt();
+        const QString percent = muted ? tr("Muted") : QStringLiteral("%1%").arg(qRound(volume * 100. / PA_VOLUME_NORM));
+        const int percentWidth = option.fontMetrics.boundingRect(QStringLiteral("100%")).width() + MARGIN;
+
+        painter->drawText(volumeLine, Qt::AlignRight | Qt::AlignVCenter, percent);
+
+        const QRect track(volumeLine.x(), volumeLine.center().y() - VOLUME_BAR_HEIGHT / 2,
+                          volumeLine.width() - percentWidth - MARGIN, VOLUME_BAR_HEIGHT);
+        const int filled = qRound(track.width() * double(volume) / PA_VOLUME_UI_MAX);
+        const int norm = track.x() + qRound(track.width() * double(PA_VOLUME_NORM) / PA_VOLUME_UI_MAX);
+
+        painter->fillRect(track, option.palette.color(group, QPalette::Mid));
+        painter->fillRect(track.x(), track.y(), filled, track.height(), option.palette.color(group, QPalette::Highlight));
+        painter->drawLine(norm, track.top() - 2, norm, track.bottom() + 2);
+
+        painter->restore();
+    }
+
+    QWidget *createEditor(QWidget *parent, const QStyleOptionViewItem &, const QModelIndex &) const override
+    {
+        StreamRowEditor *editor = new StreamRowEditor(parent);
+
+        connect(editor, &StreamRowEditor::edited, this, [this, editor] {
+            Q_EMIT const_cast<StreamDelegate *>(this)->commitData(editor);
+        });
+
+        return editor;
+    }
+
+    void setEditorData(QWidget *widget, const QModelIndex &index) const override
+    {
+        StreamRowEditor *editor = static_cast<StreamRowEditor *>(widget);
+
+        // Don't yank the slider away while it's being dragged
+        if (editor->slider->isSliderDown()) {
+            return;
+        }
+
+        const QSignalBlocker sliderBlocker(editor->slider);
+        const QSignalBlocker muteBlocker(editor->muteButton);
+        editor->slider->setValue(index.data(StreamListModel::VolumeRole).toInt());
+        editor->muteButton->setChecked(index.data(StreamListModel::MuteRole).toBool());
+    }
+
+    void setModelData(QWidget *widget, QAbstractItemModel *model, const QModelIndex &index) const override
+    {
+        StreamRowEditor *editor = static_cast<StreamRowEditor *>(widget);
+
+        model->setData(index, editor->slider->value(), StreamListModel::VolumeRole);
+        model->setData(index, editor->muteButton->isChecked(), StreamListModel::MuteRole);
+    }
+
+    void updateEditorGeometry(QWidget *editor, const QStyleOptionViewItem &option, const QModelIndex &) const override
+    {
+        editor->setGeometry(volumeRect(option));
+    }
+
+private:
+    static QRect volumeRect(const QStyleOptionViewItem &option)
+    {
+        const QRect content = option.rect.adjusted(MARGIN, MARGIN, -MARGIN, -MARGIN);
+        const int top = content.y() + option.fontMetrics.height() + MARGIN;
+
+        return QRect(content.x() + ICON_SIZE + MARGIN, top, content.width() - ICON_SIZE - MARGIN, content.bottom() + 1 - top);
+    }
+};
+
+StreamListView::StreamListView(QWidget *parent) :
+    QListView(parent)
+{
+    setItemDelegate(new StreamDelegate(this));
+    setUniformItemSizes(true);
+    setSelectionMode(QAbstractItemView::NoSelection);
+    setEditTriggers(QAbstractItemView::NoEditTriggers);
+    setVerticalScrollMode(QAbstractItemView::ScrollPerPixel);
+    setMouseTracking(true);
+
+    connect(this, &QAbstractItemView::entered, this, &StreamListView::onEntered);
+}
+
+void StreamListView::onEntered(const QModelIndex &index)
+{
+    if (index == m_editing) {
+        return;
+    }
+
+    closeEditor();
+
+    m_editing = index;
+    openPersistentEditor(index);
+}
+
+void StreamListView::leaveEvent(QEvent *event)
+{
+    QListView::leaveEvent(event);
+
+    // Keep the editor while it's being used, e.g. a slider dragged outside
+    if (QApplication::mouseButtons() == Qt::NoButton) {
+        closeEditor();
+    }
+}
+
+void StreamListView::closeEditor()
+{
+    if (m_editing.isValid()) {
+        closePersistentEditor(m_editing);
+    }
+
+    m_editing = QPersistentModelIndex();
+}
+
+#include "streamlistview.moc"
@@ -0,0 +1,40 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <QListView>
+#include <QPersistentModelIndex>
+
+// Paints StreamListModel rows through a delegate. Only the row under the
+// mouse gets real widgets to edit volume and mute with.
+class StreamListView : public QListView
+{
+    Q_OBJECT
+
+public:
+    explicit StreamListView(QWidget *parent = nullptr);
+
+protected:
+    void leaveEvent(QEvent *event) override;
+
+private:
+    void onEntered(const QModelIndex &index);
+    void closeEditor();
+
+    QPersistentModelIndex m_editing;
+};
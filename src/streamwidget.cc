@@ -21,6 +21,7 @@
 #include "streamwidget.h"
 
 #include "mainwindow.h"
+#include "operationbatch.h"
 #include "channel.h"
 
 #include <QAction>
@@ -29,13 +30,16 @@
 #include <QLabel>
 #include <QIcon>
 #include <QToolButton>
+#include <QPointer>
 
 /*** StreamWidget ***/
 StreamWidget::StreamWidget(MainWindow *parent) :
     MinimalStreamWidget(parent),
+    volumeWriter([this]() { executeVolumeUpdate(); }),
     mpMainWindow(parent),
     terminate{new QAction{tr("Terminate"), this}}
 {
+    pa_cvolume_init(&volume);
 
     deviceButton = new QToolButton;
     topLayout->insertWidget(4, deviceButton);
@@ -43,11 +47,7 @@ StreamWidget::StreamWidget(MainWindow *parent) :
     directionLabel = new QLabel;
     topLayout->insertWidget(4, directionLabel);
 
-    initPeakProgressBar(channelsList);
-
-    timeout.setSingleShot(true);
-    timeout.setInterval(100);
-    connect(&timeout, &QTimer::timeout, this, &StreamWidget::timeoutEvent);
+    initPeakMeter(channelsList);
 
     connect(muteToggleButton, &QToolButton::toggled, this, &StreamWidget::onMuteToggleButton);
     connect(lockToggleButton, &QToolButton::toggled, this, &StreamWidget::onLockToggleButton);
@@ -56,18 +56,17 @@ StreamWidget::StreamWidget(MainWindow *parent) :
     connect(terminate, &QAction::triggered, this, &StreamWidget::onKill);
     addAction(terminate);
     setContextMenuPolicy(Qt::ActionsContextMenu);
-
-    for (size_t i=0; i<PA_CHANNELS_MAX; i++) {
-        channels[i] = nullptr;
-    }
 }
 
 void StreamWidget::setChannelMap(const pa_channel_map &m, bool can_decibel)
 {
+    // Recycled widgets keep their channels, only the positions may differ
+    const bool reuse = channelMap.channels == m.channels;
+
     channelMap = m;
 
     for (int i = 0; i < m.channels; i++) {
-        Channel *ch = channels[i] = new Channel(channelsList);
+        Channel *ch = reuse ? channels[i] : (channels[i] = new Channel(channelsList));
         ch->channel = i;
         ch->can_decibel = can_decibel;
         ch->minimalStreamWidget = this;
@@ -81,6 +80,7 @@ void StreamWidget::setChannelMap(const pa_channel_map &m, bool can_decibel)
 
     lockToggleButton->setEnabled(m.channels > 1);
     hideLockedChannels(lockToggleButton->isChecked());
+    updateMeterVisibility();
 }
 
 void StreamWidget::setVolume(const pa_cvolume &v, bool force)
@@ -89,7 +89,7 @@ void StreamWidget::setVolume(const pa_cvolume &v, bool force)
 
     volume = v;
 
-    if (!timeout.isActive() || force) { /* do not update the volume when a volume change is still in flux */
+    if ((!volumeWriter.isBusy() && !volumeFade.isRunning()) || force) { /* do not update the volume when a volume change is still in flux */
         for (int i = 0; i < volume.channels; i++) {
             channels[i]->setVolume(volume.values[i]);
         }
@@ -101,6 +101,9 @@ void StreamWidget::updateChannelVolume(int channel, pa_volume_t v)
     pa_cvolume n;
     Q_ASSERT(channel < volume.channels);
 
+    // The user takes over, a mute fading out still gets its mute
+    volumeFade.finish();
+
     n = volume;
 
     if (lockToggleButton->isChecked()) {
@@ -111,10 +114,87 @@ void StreamWidget::updateChannelVolume(int channel, pa_volume_t v)
         n.values[channel] = v;
     }
 
+    const pa_cvolume before = volume;
     setVolume(n, true);
 
-    if (!timeout.isActive()) {
-        timeout.start();
+    volumeWriter.write();
+
+    Q_EMIT volumeEdited(before);
+}
+
+void StreamWidget::fadeTo(const pa_cvolume &target, int msecs, const std::function<void()> &done)
+{
+    Q_ASSERT(target.channels == volume.channels);
+
+    volumeFade.finish();
+    volumeFade.start(volume, target, msecs, [this](const pa_cvolume &v) {
+        setVolume(v, true);
+        volumeWriter.write();
+    }, done);
+}
+
+void StreamWidget::applyMute(OperationBatch *batch)
+{
+    if (!batch) {
+        Q_EMIT muteEdited();
+
+        // The rest of the selection follows along, this widget included
+        if (isSelected()) {
+            return;
+        }
+    }
+
+    volumeFade.finish();
+
+    // Taken now, the button follows the server while the fade runs
+    const bool mute = muteToggleButton->isChecked();
+    const unsigned serial = ++muteSerial;
+
+    const int msecs = VolumeFade::muteDuration();
+    if (msecs <= 0 || pa_cvolume_is_muted(&volume)) {
+        executeMuteUpdate(mute, batch);
+        return;
+    }
+
+    // The sliders keep showing the volume we come back to
+    const pa_cvolume target = volume;
+    pa_cvolume silent = volume;
+    pa_cvolume_mute(&silent, silent.channels);
+
+    const VolumeFade::StepFunction step = [this](const pa_cvolume &v) {
+        volume = v;
+        volumeWriter.write();
+    };
+
+    // The mute goes out once the writer has caught up, the batch waits
+    const QPointer<OperationBatch> deferredBatch(batch);
+    const OperationBatch::Hold hold = batch ? batch->hold() : OperationBatch::Hold();
+
+    if (mute) {
+        // Silence, the mute, then the volume to come back to
+        volumeFade.start(target, silent, msecs, step, [this, serial, target, deferredBatch, hold]() {
+            volumeWriter.whenWritten([this, serial, target, deferredBatch, hold]() {
+                if (serial != muteSerial) {
+                    return;
+                }
+
+                executeMuteUpdate(true, deferredBatch);
+                volume = target;
+                volumeWriter.write();
+            });
+        });
+    } else {
+        // Silence before the unmute, then faded in
+        volume = silent;
+        volumeWriter.write();
+        volumeWriter.whenWritten([this, serial, silent, target, msecs, step, deferredBatch, hold]() {
+            if (serial != muteSerial) {
+                return;
+            }
+
+            executeMuteUpdate(false, deferredBatch);
+            volumeFade.start(silent, target, msecs, step);
+        });
     }
 }
 
@@ -124,7 +204,23 @@ void StreamWidget::hideLockedChannels(bool hide)
         channels[i]->setVisible(!hide);
     }
 
-    channels[channelMap.channels - 1]->channelLabel->setVisible(!hide);
+    channels[channelMap.channels - 1]->setLabelVisible(!hide);
+}
+
+void StreamWidget::resetForReuse()
+{
+    // A pending write would hit whatever stream gets this index next
+    volumeFade.stop();
+    volumeWriter.cancel();
+    setSelected(false);
+
+    updating = true;
+    muteToggleButton->setChecked(false);
+    lockToggleButton->setChecked(true);
+    updating = false;
+
+    pa_cvolume_init(&volume);
+    resetMeters();
 }
 
 void StreamWidget::onMuteToggleButton()
@@ -142,14 +238,14 @@ void StreamWidget::onLockToggleButton()
     hideLockedChannels(lockToggleButton->isChecked());
 }
 
-bool StreamWidget::timeoutEvent()
+void StreamWidget::executeVolumeUpdate()
 {
-    executeVolumeUpdate();
-    return false;
 }
 
-void StreamWidget::executeVolumeUpdate()
+void StreamWidget::executeMuteUpdate(bool mute, OperationBatch *batch)
 {
+    Q_UNUSED(mute);
+    Q_UNUSED(batch);
 }
 
 void StreamWidget::onDeviceChangePopup()
@@ -24,11 +24,13 @@
 #include "pavucontrol.h"
 
 #include "minimalstreamwidget.h"
+#include "volumefade.h"
+#include "volumewriter.h"
 #include <QWidget>
-#include <QTimer>
 
 class MainWindow;
 class Channel;
+class OperationBatch;
 class QAction;
 class QLabel;
 class QToolButton;
@@ -45,25 +47,44 @@ public:
 
     void hideLockedChannels(bool hide = true);
 
-    pa_channel_map channelMap;
+    // Forgets the stream, keeping the channels for one with as many
+    void resetForReuse();
+
+    // Ramps the volume to target, moving the sliders along. done runs once
+    // the last step has been handed to the writer.
+    void fadeTo(const pa_cvolume &target, int msecs, const std::function<void()> &done = {});
+
+    // Sends the mute button's state, fading out before or in after it.
+    // Without a batch a selected widget leaves it to the selection.
+    void applyMute(OperationBatch *batch = nullptr);
+
     pa_cvolume volume;
 
-    Channel *channels[PA_CHANNELS_MAX];
+    // What the stream is found by again after it was recreated, see
+    // utils::streamKey()
+    QByteArray key;
 
     virtual void onMuteToggleButton();
     virtual void onLockToggleButton();
     virtual void onDeviceChangePopup();
 
-    QTimer timeout;
-
-    bool timeoutEvent();
+    VolumeWriter volumeWriter;
+    VolumeFade volumeFade;
+    // Bumped by every applyMute(), a deferred mute that has been overtaken
+    // by a newer one is dropped
+    unsigned muteSerial = 0;
 
     virtual void executeVolumeUpdate();
+    virtual void executeMuteUpdate(bool mute, OperationBatch *batch = nullptr);
     virtual void onKill();
 
     QLabel *directionLabel;
     QToolButton *deviceButton;
 
+Q_SIGNALS:
+    // The user picked another device for this stream, a selected one moves
+    // together with the rest of the selection
+    void moveEdited(uint32_t deviceIndex);
 
 protected:
     MainWindow *mpMainWindow;
@@ -2,59 +2,31 @@
 
 #include <QString>
 #include <QSet>
-#include <QIcon>
+#include <QHash>
 
-#include <pulse/proplist.h>
+#include "iconcache.h"
+#include "properties.h"
 
 namespace utils {
-    template<typename T>
-    inline QString readProperty(const T &info, const char *key) {
-        const char *value = pa_proplist_gets(info.proplist, key);
-        if (!value) {
-            return QString();
-        }
-        return QString::fromUtf8(value);
-    }
-
-    template<typename T>
-    inline QString readProperty(const T &info, const QString &key) {
-        return readProperty(info, key.toUtf8().constData());
-    }
-
-    QIcon iconByName(const QString &name, const QString &fallback) {
-        if (name.isEmpty()) {
-            return QIcon::fromTheme(fallback);
-        }
-        QIcon icon = QIcon::fromTheme(name);
-        if (icon.isNull()) {
-            return QIcon::fromTheme(fallback);
-        }
-
-        return icon;
-    }
-
-    template<typename T>
-    inline QIcon findIcon(const T &info, const char *fallback) {
-        static const QVector<QString> iconPropertyNames({
-            PA_PROP_MEDIA_ICON_NAME,
-            PA_PROP_WINDOW_ICON_NAME,
-            PA_PROP_APPLICATION_ICON_NAME,
-        });
-
-        for (const QString &property : iconPropertyNames) {
-            const QString value = readProperty(info, property);
+    // Returns the name of the icon to show, the caller still has to hand
+    // IconCache the fallback in case the theme lacks the role icon
+    inline QString findIconName(const Properties &properties, const char *fallback) {
+        for (const QString &value : {
+                properties.mediaIconName,
+                properties.windowIconName,
+                properties.applicationIconName,
+            }) {
             if (value.isEmpty()) {
                 continue;
             }
-            QIcon icon = QIcon::fromTheme(value);
-            if (!icon.isNull()) {
-                return icon;
+            if (IconCache::instance()->hasThemeIcon(value)) {
+                return value;
             }
         }
 
-        const QString role = readProperty(info, PA_PROP_MEDIA_ROLE);
+        const QString &role = properties.mediaRole;
         if (role.isEmpty()) {
-            return QIcon::fromTheme(QLatin1String(fallback));
+            return QLatin1String(fallback);
         }
 
         static const QHash<QString, QString> roleIcons({
@@ -65,22 +37,15 @@ namespace utils {
             {"event", "dialog-information"},
         });
 
-        if (roleIcons.contains(role)) {
-            return QIcon::fromTheme(roleIcons[role]);
-        }
-
-        return QIcon::fromTheme(QLatin1String(fallback));
+        return roleIcons.value(role, QLatin1String(fallback));
     }
 
-    template<typename T>
-    inline bool heuristicIsHeadset(const T &info) {
-        const QString bus = readProperty(info, PA_PROP_DEVICE_BUS);
-
-        if (bus != QLatin1String("usb")) {
+    inline bool heuristicIsHeadset(const Properties &properties) {
+        if (properties.deviceBus != QLatin1String("usb")) {
             return false;
         }
 
-        const QString vendor = readProperty(info, PA_PROP_DEVICE_VENDOR_ID);
+        const QString &vendor = properties.deviceVendorId;
 
         // Vendors that only produce USB headsets, not other kinds of USB audio cards
 
@@ -96,11 +61,8 @@ namespace utils {
         return false;
     }
 
-    template<typename T>
-    inline bool heuristicIsDisplay(const T &info) {
-        const QString description = utils::readProperty(info, PA_PROP_DEVICE_DESCRIPTION);
-
-        if (description.contains(QLatin1String("hdmi"), Qt::CaseInsensitive)) {
+    inline bool heuristicIsDisplay(const Properties &properties) {
+        if (properties.deviceDescription.contains(QLatin1String("hdmi"), Qt::CaseInsensitive)) {
             // Logitech USB headset
             return true;
         }
@@ -109,35 +71,17 @@ namespace utils {
     }
 
 
-    template<typename T>
-    inline QIcon deviceIcon(const T &info) {
-        static const QIcon defaultIcon = QIcon::fromTheme("audio-card");
-        static const QIcon headsetIcon = QIcon::fromTheme("audio-headset");
-        static const QIcon hdmiIcon = QIcon::fromTheme("tv");
-
+    // Falls back to "audio-card" when handed to IconCache
+    inline QString deviceIconName(const Properties &properties) {
         // Trust our own heuristics more than pulseaudio/udev
-        if (heuristicIsHeadset(info)) {
-            return headsetIcon;
-        }
-        if (heuristicIsDisplay(info)) {
-            return hdmiIcon;
-        }
-
-        const QString iconName = readProperty(info, PA_PROP_DEVICE_ICON_NAME);
-        if (iconName.isEmpty()) {
-            if (heuristicIsHeadset(info)) {
-                return headsetIcon;
-            } else {
-                return defaultIcon;
-            }
+        if (heuristicIsHeadset(properties)) {
+            return QStringLiteral("audio-headset");
         }
-
-        QIcon icon = QIcon::fromTheme(iconName);
-        if (icon.isNull()) {
-            return defaultIcon;
+        if (heuristicIsDisplay(properties)) {
+            return QStringLiteral("tv");
         }
 
-        return icon;
+        return properties.deviceIconName;
     }
 
     // pipewire is missing most of the "proper" properties, so we hardcode this instead
@@ -147,23 +91,35 @@ namespace utils {
             "org.kde.kmixd"
             });
 
-    template<typename T>
-    inline bool shouldIgnoreApp(const T &info) {
-        if (mixers.contains(utils::readProperty(info, PA_PROP_APPLICATION_ID))) {
+    inline bool shouldIgnoreApp(const Properties &properties) {
+        if (mixers.contains(properties.applicationId)) {
             return true;
         }
 
         // Handled by system event thing
         // Does not work with pipewire, hence the test above as well
-        if (utils::readProperty(info, "module-stream-restore.id") == "sink-input-by-media-role:event") {
+        if (properties.streamRestoreId == QLatin1String("sink-input-by-media-role:event")) {
             return true;
         }
         // Empty from pipewire
-        if (utils::readProperty(info, PA_PROP_MEDIA_ROLE) == "event") {
+        if (properties.mediaRole == QLatin1String("event")) {
             return true;
         }
 
         return false;
     }
+
+    // What a stream is recognized by again later, empty if nothing
+    inline QByteArray streamKey(const Properties &properties) {
+        if (shouldIgnoreApp(properties)) {
+            return QByteArray();
+        }
+
+        if (!properties.streamRestoreId.isEmpty()) {
+            return properties.streamRestoreId.toUtf8();
+        }
+
+        return properties.applicationName.toUtf8();
+    }
 }
 
@@ -0,0 +1,157 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "volumefade.h"
+
+#include <QtGlobal>
+
+#include <utility>
+
+// Interpolated steps go out at most this often, the final one always does.
+// Faster than this is inaudible and only floods the server.
+static const qint64 minStepInterval = 20;
+
+static int s_muteDuration = 0;
+static int s_rampDuration = 0;
+static QEasingCurve::Type s_curve = QEasingCurve::Linear;
+
+VolumeFade::~VolumeFade()
+{
+    FrameTicker::instance()->unschedule(this);
+}
+
+void VolumeFade::start(const pa_cvolume &from, const pa_cvolume &to, int msecs,
+                       const StepFunction &step, const std::function<void()> &done)
+{
+    Q_ASSERT(from.channels == to.channels);
+
+    stop();
+
+    m_from = from;
+    m_to = to;
+    m_curve = QEasingCurve(s_curve);
+    m_step = step;
+    m_done = done;
+
+    if (msecs <= 0) {
+        m_running = true;
+        finish();
+        return;
+    }
+
+    m_start = FrameTicker::instance()->now();
+    m_lastStep = m_start;
+    m_duration = msecs;
+    m_running = true;
+
+    FrameTicker::instance()->schedule(this);
+}
+
+void VolumeFade::finish()
+{
+    if (!m_running) {
+        return;
+    }
+
+    FrameTicker::instance()->unschedule(this);
+    m_running = false;
+
+    // Moved out first, done may well start the next fade
+    const StepFunction step = std::move(m_step);
+    const std::function<void()> done = std::move(m_done);
+
+    step(m_to);
+
+    if (done) {
+        done();
+    }
+}
+
+void VolumeFade::stop()
+{
+    if (!m_running) {
+        return;
+    }
+
+    FrameTicker::instance()->unschedule(this);
+    m_running = false;
+    m_step = nullptr;
+    m_done = nullptr;
+}
+
+bool VolumeFade::advanceFrame(qint64 msecs)
+{
+    if (msecs - m_start >= m_duration) {
+        finish();
+        // done may have started the next fade already
+        return m_running;
+    }
+
+    if (msecs - m_lastStep < minStepInterval) {
+        return true;
+    }
+
+    m_lastStep = msecs;
+    step(qreal(msecs - m_start) / m_duration);
+
+    return true;
+}
+
+void VolumeFade::step(qreal progress)
+{
+    const qreal t = m_curve.valueForProgress(progress);
+
+    pa_cvolume v = m_to;
+    for (int i = 0; i < v.channels; i++) {
+        const qreal from = m_from.values[i];
+        const qreal to = m_to.values[i];
+        v.values[i] = pa_volume_t(qRound64(from + (to - from) * t));
+    }
+
+    m_step(v);
+}
+
+int VolumeFade::muteDuration()
+{
+    return s_muteDuration;
+}
+
+void VolumeFade::setMuteDuration(int msecs)
+{
+    s_muteDuration = qMax(0, msecs);
+}
+
+int VolumeFade::rampDuration()
+{
+    return s_rampDuration;
+}
+
+void VolumeFade::setRampDuration(int msecs)
+{
+    s_rampDuration = qMax(0, msecs);
+}
+
+QEasingCurve::Type VolumeFade::curve()
+{
+    return s_curve;
+}
+
+void VolumeFade::setCurve(QEasingCurve::Type type)
+{
+    s_curve = type;
+}
@@ -0,0 +1,80 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include "frameticker.h"
+
+#include <QEasingCurve>
+
+#include <functional>
+
+#include <pulse/volume.h>
+
+// A timed ramp between two volumes, stepped by the shared FrameTicker.
+// Steps are handed to a callback, which normally writes them through the
+// widget's VolumeWriter; that keeps at most one write per object in flight
+// no matter how many fades run at once.
+class VolumeFade : public FrameTicker::Client
+{
+public:
+    typedef std::function<void(const pa_cvolume &)> StepFunction;
+
+    VolumeFade() = default;
+    ~VolumeFade() override;
+
+    // Ramps from from to to over msecs with the default curve. step gets
+    // every interpolated volume, the exact target last; done runs after it.
+    void start(const pa_cvolume &from, const pa_cvolume &to, int msecs,
+               const StepFunction &step, const std::function<void()> &done = {});
+
+    // Jumps to the target, as if the fade had run its course
+    void finish();
+
+    // Drops the fade where it is, without the final step
+    void stop();
+
+    bool isRunning() const { return m_running; }
+
+    // Duration used when muting and unmuting, 0 to switch immediately
+    static int muteDuration();
+    static void setMuteDuration(int msecs);
+
+    // Duration used when undoing, redoing or restoring a scene, 0 to jump
+    static int rampDuration();
+    static void setRampDuration(int msecs);
+
+    static QEasingCurve::Type curve();
+    static void setCurve(QEasingCurve::Type type);
+
+    bool advanceFrame(qint64 msecs) override;
+
+private:
+    void step(qreal progress);
+
+    pa_cvolume m_from;
+    pa_cvolume m_to;
+    QEasingCurve m_curve;
+    qint64 m_start = 0;
+    qint64 m_lastStep = 0;
+    int m_duration = 0;
+    bool m_running = false;
+
+    StepFunction m_step;
+    std::function<void()> m_done;
+};
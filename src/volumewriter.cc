@@ -0,0 +1,120 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#include "volumewriter.h"
+
+#include <QDebug>
+
+#include <utility>
+
+VolumeWriter::VolumeWriter(std::function<void()> send) :
+    m_send(std::move(send))
+{
+}
+
+VolumeWriter::~VolumeWriter()
+{
+    cancel();
+}
+
+void VolumeWriter::write()
+{
+    if (isBusy()) {
+        m_pending = true;
+        return;
+    }
+
+    m_send();
+}
+
+void VolumeWriter::track(pa_operation *o)
+{
+    if (m_operation) {
+        // Otherwise its callback would retire the new operation
+        pa_operation_cancel(m_operation);
+        pa_operation_unref(m_operation);
+    }
+
+    m_operation = pa_operation_ref(o);
+}
+
+void VolumeWriter::whenWritten(const std::function<void()> &done)
+{
+    if (!isBusy()) {
+        done();
+        return;
+    }
+
+    m_whenWritten.append(done);
+}
+
+void VolumeWriter::cancel()
+{
+    m_pending = false;
+    m_whenWritten.clear();
+
+    if (!m_operation) {
+        return;
+    }
+
+    // No callback is made for a cancelled operation, so it can't outlive us
+    if (pa_operation_get_state(m_operation) == PA_OPERATION_RUNNING) {
+        pa_operation_cancel(m_operation);
+    }
+
+    pa_operation_unref(m_operation);
+    m_operation = nullptr;
+}
+
+bool VolumeWriter::isBusy() const
+{
+    // Operations get cancelled without a callback when the context dies
+    return m_pending || (m_operation && pa_operation_get_state(m_operation) == PA_OPERATION_RUNNING);
+}
+
+void VolumeWriter::callback(pa_context *c, int success, void *userdata)
+{
+    Q_UNUSED(c);
+    VolumeWriter *that = static_cast<VolumeWriter*>(userdata);
+
+    // Still RUNNING until we return, so drop it before sending the next one
+    pa_operation_unref(that->m_operation);
+    that->m_operation = nullptr;
+
+    if (!success) {
+        qWarning() << "Volume change failed";
+    }
+
+    if (that->m_pending) {
+        that->m_pending = false;
+        that->m_send();
+        return;
+    }
+
+    if (success) {
+        Q_EMIT that->written();
+    }
+
+    // Moved out first, they may well write again
+    const QVector<std::function<void()>> whenWritten = std::move(that->m_whenWritten);
+    that->m_whenWritten.clear();
+
+    for (const std::function<void()> &done : whenWritten) {
+        done();
+    }
+}
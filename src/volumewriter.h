@@ -0,0 +1,69 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+
+#pragma once
+
+#include <QObject>
+#include <QVector>
+
+#include <functional>
+
+#include <pulse/context.h>
+#include <pulse/operation.h>
+
+// Write pipeline for one widget's volume. At most one write is in flight;
+// moves made meanwhile only mark the volume dirty, and the newest value is
+// sent as soon as the server acknowledges the previous write. Slider drags
+// thus follow as fast as the server keeps up, without a fixed delay.
+class VolumeWriter : public QObject
+{
+    Q_OBJECT
+public:
+    // send starts the write of the current volume, see track()
+    explicit VolumeWriter(std::function<void()> send);
+    ~VolumeWriter() override;
+
+    // Sends now, or once the write in flight has completed
+    void write();
+
+    // Adopts the operation started by send, created with callback() and
+    // this as userdata. Supersedes any write still in flight.
+    void track(pa_operation *o);
+
+    // Runs done once everything written so far has been answered, right
+    // away if nothing is in flight. cancel() drops it.
+    void whenWritten(const std::function<void()> &done);
+
+    // Forgets the write in flight and any pending one
+    void cancel();
+
+    // While true the server's idea of the volume is older than ours
+    bool isBusy() const;
+
+    static void callback(pa_context *c, int success, void *userdata);
+
+Q_SIGNALS:
+    // The newest volume has been applied
+    void written();
+
+private:
+    std::function<void()> m_send;
+    pa_operation *m_operation = nullptr;
+    bool m_pending = false;
+    QVector<std::function<void()>> m_whenWritten;
+};
@@ -0,0 +1,82 @@
+/***
+  This file is part of pavucontrol-qt.
+
+  pavucontrol-qt is free software; you can redistribute it and/or modify
+  it under the terms of the GNU General Public License as published by
+  the Free Software Foundation, either version 2 of the License, or
+  (at your option) any later version.
+
+  pavucontrol-qt is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE. See the GNU
+  General Public License for more details.
+
+  You should have received a copy of the GNU General Public License
+  along with pavucontrol-qt. If not, see <https://www.gnu.org/licenses/>.
+***/
+
+#pragma once
+
+#include <QHash>
+#include <QVector>
+
+// Parks widgets that are expensive to build so the next object of the same
+// shape can reuse them. The caller resets them before parking and owns
+// whatever take() returns.
+template<typename T>
+class WidgetPool
+{
+public:
+    explicit WidgetPool(int capacity) :
+        m_capacity(capacity)
+    {
+    }
+
+    ~WidgetPool()
+    {
+        for (const QVector<T *> &widgets : m_parked) {
+            qDeleteAll(widgets);
+        }
+    }
+
+    WidgetPool(const WidgetPool &) = delete;
+    WidgetPool &operator=(const WidgetPool &) = delete;
+
+    // nullptr when nothing fits, the caller creates a new one then
+    T *take(int key)
+    {
+        QVector<T *> &widgets = m_parked[key];
+
+        if (widgets.isEmpty()) {
+            m_misses++;
+            return nullptr;
+        }
+
+        m_hits++;
+        m_size--;
+        return widgets.takeLast();
+    }
+
+    // Returns false when the pool is full, the caller deletes it then
+    bool park(int key, T *widget)
+    {
+        if (m_size >= m_capacity) {
+            return false;
+        }
+
+        m_parked[key].append(widget);
+        m_size++;
+        return true;
+    }
+
+    int size() const { return m_size; }
+    quint64 hits() const { return m_hits; }
+    quint64 misses() const { return m_misses; }
+
+private:
+    QHash<int, QVector<T *>> m_parked;
+    int m_capacity;
+    int m_size = 0;
+    quint64 m_hits = 0;
+    quint64 m_misses = 0;
+};